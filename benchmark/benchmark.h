@@ -0,0 +1,73 @@
+#ifndef _BENCHMARK
+#define _BENCHMARK
+
+#include <iostream>
+#include <string>
+#include <chrono>
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::string unit;
+    unsigned int iterations = 0;
+    double seconds = 0;
+    double items = 0;
+
+    double per_second() { return this->items / this->seconds; }
+};
+// a measure that is not a rate (sizes, calls per frame...)
+struct BenchmarkValue
+{
+    std::string name;
+    std::string unit;
+    double value = 0;
+};
+
+// keeps the optimizer from removing the benchmarked work
+extern volatile unsigned int benchmark_sink;
+
+// call function until min_time seconds have elapsed
+// function must return the number of items it processed (voxels, cells, rays...)
+template <typename F>
+BenchmarkResult run_benchmark(std::string name, std::string unit, F function, double min_time = 0.5) {
+    BenchmarkResult result;
+    result.name = name;
+    result.unit = unit;
+
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = std::chrono::duration<double>(0);
+    while (elapsed.count() < min_time) {
+        result.items += function();
+        result.iterations++;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+    result.seconds = elapsed.count();
+    return result;
+}
+
+// print to the console and keep for the json report (--json file)
+void print_result(BenchmarkResult result);
+void print_value(BenchmarkValue value);
+// only kept for the json report, the caller prints it its own way
+void record_value(BenchmarkValue value);
+
+void run_generation_benchmarks();
+// returns the batched samples that differ from the scalar reference (the run fails if there are any)
+unsigned int run_noise_benchmarks();
+void run_pipeline_benchmarks();
+// Materials lookups, alone and in the visibility test of the flatten
+void run_material_benchmarks();
+// needs an OpenGL 4.5 context, skipped without one
+void run_buffer_benchmarks();
+// headless, on the mock buffer device, returns the errors found (the run fails if there are any)
+unsigned int run_streaming_benchmarks();
+// entity systems against a generated world, 1 to 100k entities
+void run_entity_benchmarks();
+// Vector3 math alone and in the raycasts
+void run_vector_benchmarks();
+// morton codes alone, per kernel, and in the chunk storage
+void run_morton_benchmarks();
+// Chunk::generate and Chunk::flatten per lod, World::get and the edit uploads on the mock buffer device
+void run_world_benchmarks();
+
+#endif
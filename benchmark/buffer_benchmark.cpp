@@ -0,0 +1,92 @@
+#include <vector>
+
+#include "./benchmark.h"
+#include "../class/utility/graphics/buffer.h"
+
+#define RESIZE_REPETITIONS 8
+// bytes inserted or removed by each resize
+#define RESIZE_STEP 4096
+
+// hidden window, the buffers only need a current context
+bool create_benchmark_context() {
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) return false;
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+
+    SDL_Window* window = SDL_CreateWindow("VoxelEngineBench", 0, 0, 16, 16, SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    if (window == NULL) return false;
+    if (SDL_GL_CreateContext(window) == NULL) return false;
+
+    glewExperimental = GL_TRUE;
+    return glewInit() == GLEW_OK;
+}
+
+// time only the resize, glFinish so the gpu copies are counted
+template <typename S, typename R>
+BenchmarkResult time_resize(std::string name, S setup, R resize) {
+    BenchmarkResult result;
+    result.name = name;
+    result.unit = "resizes";
+
+    for (int i = 0; i < RESIZE_REPETITIONS; i++)
+    {
+        setup();
+        glFinish();
+        auto start = std::chrono::steady_clock::now();
+        resize();
+        glFinish();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        result.seconds += elapsed.count();
+        result.items += 1;
+        result.iterations++;
+    }
+    return result;
+}
+
+void run_buffer_benchmarks() {
+    if (!create_benchmark_context()) {
+        std::cout << "no OpenGL 4.5 context, buffer benchmarks skipped\n";
+        return;
+    }
+
+    std::vector<char> step_data = std::vector<char>(RESIZE_STEP, 1);
+    for (unsigned int size = 1 << 18; size <= 1 << 26; size <<= 2) {
+        std::string size_name = std::to_string(size >> 10) + "KB";
+        GrowableBuffer buffer;
+
+        // full buffer, the push has to move everything to a bigger buffer object
+        print_result(time_resize("GrowableBuffer grow " + size_name, [&]() {
+            if (buffer.is_buffer()) buffer.dispose();
+            buffer = GrowableBuffer(true, RESIZE_STEP, size);
+            buffer.set_data(size, NULL);
+        }, [&]() {
+            buffer.push_data(RESIZE_STEP, &step_data[0]);
+        }));
+
+        // room left, the tail moves in place through the scratch buffer
+        print_result(time_resize("GrowableBuffer shift " + size_name, [&]() {
+            if (buffer.is_buffer()) buffer.dispose();
+            buffer = GrowableBuffer(true, RESIZE_STEP, size + RESIZE_STEP);
+            buffer.set_data(size, NULL);
+        }, [&]() {
+            buffer.replace_data(0, RESIZE_STEP, 2 * RESIZE_STEP, NULL);
+        }));
+
+        // what the resize used to be: read everything back and upload it again
+        std::vector<char> readback = std::vector<char>(size);
+        print_result(time_resize("cpu readback shift " + size_name, [&]() {
+            if (buffer.is_buffer()) buffer.dispose();
+            buffer = GrowableBuffer(true, RESIZE_STEP, size + RESIZE_STEP);
+            buffer.set_data(size, NULL);
+        }, [&]() {
+            glGetNamedBufferSubData(buffer.get_id(), 0, size, &readback[0]);
+            glNamedBufferData(buffer.get_id(), size + 2 * RESIZE_STEP, NULL, GL_DYNAMIC_DRAW);
+            glNamedBufferSubData(buffer.get_id(), 0, RESIZE_STEP, &step_data[0]);
+            glNamedBufferSubData(buffer.get_id(), RESIZE_STEP, size, &readback[0]);
+        }));
+
+        buffer.dispose();
+    }
+}
\ No newline at end of file
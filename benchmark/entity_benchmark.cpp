@@ -0,0 +1,58 @@
+#include <vector>
+#include <random>
+
+#include "./benchmark.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/world.h"
+#include "../class/gameplay/entity_store.h"
+
+#define ENTITY_BENCH_RADIUS 2
+#define ENTITY_BENCH_MAX 100000
+
+// items thrown around the spawn, they fall, slide and pile on the ground like after an explosion
+void spawn_items(EntityStore& entities, unsigned int count) {
+    std::mt19937 random = std::mt19937(1);
+    std::uniform_real_distribution<float> spread = std::uniform_real_distribution<float>(-ENTITY_BENCH_RADIUS * CHUNK_WIDTH * 0.9f, ENTITY_BENCH_RADIUS * CHUNK_WIDTH * 0.9f);
+    std::uniform_real_distribution<float> speed = std::uniform_real_distribution<float>(-10, 10);
+
+    entities.clear();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        entities.spawn(
+            Vector3(spread(random), spread(random), CHUNK_WIDTH + 0.5f + i % 8),
+            Vector3(speed(random), speed(random), speed(random)),
+            Vector3(0.25f, 0.25f, 0.25f),
+            ENTITY_VELOCITY | ENTITY_GRAVITY | ENTITY_COLLIDER);
+    }
+}
+
+// one tick of every entity system, from 1 to ENTITY_BENCH_MAX entities, on the caller alone then with the workers
+void run_entity_benchmarks() {
+    WorldGenerator generator = WorldGenerator(1);
+    World world = World(ENTITY_BENCH_RADIUS, &generator);
+    while (!world.is_loaded()) world.update(0);
+
+    JobSystem serial(0);
+    JobSystem workers;
+    EntityStore serial_entities = EntityStore(&world, &serial);
+    EntityStore parallel_entities = EntityStore(&world, &workers);
+
+    for (unsigned int count = 1; count <= ENTITY_BENCH_MAX; count *= 10)
+    {
+        spawn_items(serial_entities, count);
+        print_result(run_benchmark("entities " + std::to_string(count) + " serial", "entities", [&]() {
+            serial_entities.update(1.0f / 60);
+            return count;
+        }));
+
+        spawn_items(parallel_entities, count);
+        print_result(run_benchmark("entities " + std::to_string(count) + " " + std::to_string(workers.get_worker_count()) + " workers", "entities", [&]() {
+            parallel_entities.update(1.0f / 60);
+            return count;
+        }));
+    }
+
+    workers.dispose();
+    serial.dispose();
+    world.dispose();
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include <vector>
+
+#include "./benchmark.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/chunk.h"
+
+#define BENCH_RADIUS 1
+
+// per voxel evaluation, as Chunk::generate used to do it
+unsigned int generate_per_voxel(WorldGenerator& generator, Cell*** cells, Vector3Int origin) {
+    for (int x = 0; x < CHUNK_WIDTH; x++)
+    for (int y = 0; y < CHUNK_WIDTH; y++)
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+    {
+        cells[x][y][z] = { generator.generate_value(origin + Vector3Int(x, y, z)) };
+    }
+    return cells[0][0][0].value;
+}
+
+void run_generation_benchmarks() {
+    WorldGenerator generator = WorldGenerator(1);
+
+    Cell*** cells = new Cell**[CHUNK_WIDTH];
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+        cells[x] = new Cell*[CHUNK_WIDTH];
+        for (int y = 0; y < CHUNK_WIDTH; y++) cells[x][y] = new Cell[CHUNK_WIDTH];
+    }
+    auto clear_cells = [&]() {
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        for (int y = 0; y < CHUNK_WIDTH; y++)
+            std::fill(cells[x][y], cells[x][y] + CHUNK_WIDTH, Cell());
+    };
+
+    // one cube of chunks around the surface, like the first loaded rings
+    auto all_chunks = [&](auto generate) {
+        unsigned int voxels = 0;
+        for (int x = -BENCH_RADIUS; x <= BENCH_RADIUS; x++)
+        for (int y = -BENCH_RADIUS; y <= BENCH_RADIUS; y++)
+        for (int z = -BENCH_RADIUS; z <= BENCH_RADIUS; z++)
+        {
+            clear_cells();
+            generate(Vector3Int(x, y, z) * CHUNK_WIDTH);
+            benchmark_sink += cells[0][0][0].value;
+            voxels += CHUNK_WIDTH * CHUNK_WIDTH * CHUNK_WIDTH;
+        }
+        return voxels;
+    };
+
+    print_result(run_benchmark("generate_value per voxel", "voxels", [&]() {
+        return all_chunks([&](Vector3Int origin) { generate_per_voxel(generator, cells, origin); });
+    }));
+    print_result(run_benchmark("generate_chunk heightmap", "voxels", [&]() {
+        return all_chunks([&](Vector3Int origin) { generator.generate_chunk(cells, origin, CHUNK_WIDTH); });
+    }));
+
+    WorldGenerator noise_generator = WorldGenerator(1, 1, false);
+    print_result(run_benchmark("generate_chunk noise terrain", "voxels", [&]() {
+        return all_chunks([&](Vector3Int origin) { noise_generator.generate_chunk(cells, origin, CHUNK_WIDTH); });
+    }));
+    WorldGenerator cave_generator = WorldGenerator(1, 1, true);
+    print_result(run_benchmark("generate_chunk noise terrain and caves", "voxels", [&]() {
+        return all_chunks([&](Vector3Int origin) { cave_generator.generate_chunk(cells, origin, CHUNK_WIDTH); });
+    }));
+
+    // trilinear cave density: throughput, and quality as the share of voxels differing from the exact evaluation
+    std::vector<unsigned int> exact_values;
+    all_chunks([&](Vector3Int origin) {
+        cave_generator.generate_chunk(cells, origin, CHUNK_WIDTH);
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        for (int y = 0; y < CHUNK_WIDTH; y++)
+        for (int z = 0; z < CHUNK_WIDTH; z++)
+            exact_values.push_back(cells[x][y][z].value);
+    });
+    for (unsigned int spacing : { 4, 8 }) {
+        WorldGenerator lattice_generator = WorldGenerator(1, 1, true);
+        lattice_generator.set_density_lattice(spacing);
+
+        unsigned int index = 0;
+        unsigned int differences = 0;
+        unsigned int voxels = all_chunks([&](Vector3Int origin) {
+            lattice_generator.generate_chunk(cells, origin, CHUNK_WIDTH);
+            for (int x = 0; x < CHUNK_WIDTH; x++)
+            for (int y = 0; y < CHUNK_WIDTH; y++)
+            for (int z = 0; z < CHUNK_WIDTH; z++)
+                if (cells[x][y][z].value != exact_values[index++]) differences++;
+        });
+        print_value({ "cave lattice " + std::to_string(spacing) + " voxels differing from exact", "%", 100.0 * differences / voxels });
+
+        print_result(run_benchmark("generate_chunk noise terrain and caves, lattice " + std::to_string(spacing), "voxels", [&]() {
+            return all_chunks([&](Vector3Int origin) { lattice_generator.generate_chunk(cells, origin, CHUNK_WIDTH); });
+        }));
+    }
+
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+        for (int y = 0; y < CHUNK_WIDTH; y++) delete[] cells[x][y];
+        delete[] cells[x];
+    }
+    delete[] cells;
+
+    // whole Chunk::generate (cells and flatten) at each lod, coarse lods only go down to their cell size
+    Chunk chunk;
+    for (int lod = CHUNK_RESOLUTION; lod >= CHUNK_RESOLUTION - 3; lod--) {
+        print_result(run_benchmark("Chunk::generate noise terrain and caves lod " + std::to_string(lod), "chunks", [&]() {
+            unsigned int chunks = 0;
+            for (int x = -BENCH_RADIUS; x <= BENCH_RADIUS; x++)
+            for (int y = -BENCH_RADIUS; y <= BENCH_RADIUS; y++)
+            for (int z = -BENCH_RADIUS; z <= BENCH_RADIUS; z++)
+            {
+                chunk.generate(cave_generator, Vector3Int(x, y, z), lod);
+                benchmark_sink += chunk.flatten()->size();
+                chunks++;
+            }
+            return chunks;
+        }));
+    }
+    chunk.dispose();
+}
@@ -0,0 +1,123 @@
+#include <vector>
+#include <fstream>
+#include <cmath>
+#include <cstring>
+#include <cstdio>
+
+#include "./benchmark.h"
+
+volatile unsigned int benchmark_sink = 0;
+
+std::vector<BenchmarkResult> benchmark_results;
+std::vector<BenchmarkValue> benchmark_values;
+
+void print_result(BenchmarkResult result) {
+    std::cout << result.name << ": "
+        << result.per_second() << " " << result.unit << "/s ("
+        << result.iterations << " iterations, " << result.seconds << "s)\n";
+    benchmark_results.push_back(result);
+}
+void print_value(BenchmarkValue value) {
+    std::cout << value.name << ": " << value.value << " " << value.unit << "\n";
+    record_value(value);
+}
+void record_value(BenchmarkValue value) {
+    benchmark_values.push_back(value);
+}
+
+#pragma region json
+std::string json_string(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+// json has no inf or nan
+std::string json_number(double number) {
+    if (!std::isfinite(number)) return "null";
+    char text[32];
+    snprintf(text, sizeof(text), "%.9g", number);
+    return text;
+}
+// one object per benchmark, their names stay the same from one commit to the next to compare runs
+bool write_json(const char* path) {
+    std::ofstream file = std::ofstream(path);
+    if (!file.is_open()) return false;
+
+    file << "{\n";
+    #ifdef __VERSION__
+    file << "  \"compiler\": " << json_string(__VERSION__) << ",\n";
+    #endif
+    #ifdef NDEBUG
+    file << "  \"asserts\": false,\n";
+    #else
+    file << "  \"asserts\": true,\n";
+    #endif
+
+    file << "  \"results\": [";
+    for (unsigned int i = 0; i < benchmark_results.size(); i++)
+    {
+        BenchmarkResult& result = benchmark_results[i];
+        file << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": " << json_string(result.name)
+            << ", \"unit\": " << json_string(result.unit + "/s")
+            << ", \"per_second\": " << json_number(result.per_second())
+            << ", \"items\": " << json_number(result.items)
+            << ", \"iterations\": " << result.iterations
+            << ", \"seconds\": " << json_number(result.seconds) << "}";
+    }
+    file << "\n  ],\n";
+
+    file << "  \"values\": [";
+    for (unsigned int i = 0; i < benchmark_values.size(); i++)
+    {
+        BenchmarkValue& value = benchmark_values[i];
+        file << (i == 0 ? "\n" : ",\n")
+            << "    {\"name\": " << json_string(value.name)
+            << ", \"unit\": " << json_string(value.unit)
+            << ", \"value\": " << json_number(value.value) << "}";
+    }
+    file << "\n  ]\n}\n";
+    return file.good();
+}
+#pragma endregion
+
+// --json file: also write every result to file
+int main(int argc, char *args[]) {
+    const char* json_path = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(args[i], "--json") == 0 && i + 1 < argc) json_path = args[++i];
+    }
+
+    run_generation_benchmarks();
+    unsigned int noise_mismatches = run_noise_benchmarks();
+    run_pipeline_benchmarks();
+    run_material_benchmarks();
+    run_buffer_benchmarks();
+    unsigned int streaming_errors = run_streaming_benchmarks();
+    run_entity_benchmarks();
+    run_vector_benchmarks();
+    run_morton_benchmarks();
+    run_world_benchmarks();
+
+    if (json_path != nullptr) {
+        if (!write_json(json_path)) {
+            std::cerr << "could not write " << json_path << "\n";
+            return 1;
+        }
+        std::cout << "results written to " << json_path << "\n";
+    }
+    if (noise_mismatches != 0) {
+        std::cerr << "noise: " << noise_mismatches << " samples differ from the scalar reference\n";
+        return 1;
+    }
+    if (streaming_errors != 0) {
+        std::cerr << "streaming: " << streaming_errors << " errors\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <vector>
+
+#include "./benchmark.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/chunk.h"
+
+// Materials::see_through before the registry, the reference of the comparisons generated from it
+bool see_through_switch(unsigned int material_id) {
+    switch (material_id)
+    {
+    case MATERIAL_AIR:
+        return true;
+    case MATERIAL_WATER:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// the test of Chunk::has_side_visible on every voxel inside the chunk: itself and its 6 neighbours
+// values are in x / y / z order, CHUNK_WIDTH^3 of them
+template <typename F>
+unsigned int visible_voxels(const unsigned int* values, F see_through) {
+    const int dx = CHUNK_WIDTH * CHUNK_WIDTH, dy = CHUNK_WIDTH, dz = 1;
+    unsigned int visible = 0;
+    for (int x = 1; x < CHUNK_WIDTH - 1; x++)
+    for (int y = 1; y < CHUNK_WIDTH - 1; y++)
+    for (int z = 1; z < CHUNK_WIDTH - 1; z++)
+    {
+        const unsigned int* v = values + x * dx + y * dy + z * dz;
+        visible += see_through(v[0])
+            || see_through(v[dx]) || see_through(v[-dx])
+            || see_through(v[dy]) || see_through(v[-dy])
+            || see_through(v[dz]) || see_through(v[-dz]);
+    }
+    return visible;
+}
+
+void run_material_benchmarks() {
+    // the surface chunk with caves and water, most voxels are stone, air or water
+    WorldGenerator generator = WorldGenerator(1, 1, true);
+    Chunk chunk;
+    chunk.generate(generator, Vector3Int(0, 0, -1), CHUNK_RESOLUTION);
+
+    std::vector<unsigned int> ids;
+    for (int x = 0; x < CHUNK_WIDTH; x++)
+    for (int y = 0; y < CHUNK_WIDTH; y++)
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        ids.push_back(chunk.get(Vector3Int(x, y, z)));
+
+    print_result(run_benchmark("material lookup switch", "lookups", [&]() {
+        unsigned int count = 0;
+        for (unsigned int id : ids) count += see_through_switch(id);
+        benchmark_sink += count;
+        return ids.size();
+    }));
+    print_result(run_benchmark("material lookup registry comparisons", "lookups", [&]() {
+        unsigned int count = 0;
+        for (unsigned int id : ids) count += Materials::see_through(id);
+        benchmark_sink += count;
+        return ids.size();
+    }));
+
+    unsigned int voxels = (CHUNK_WIDTH - 2) * (CHUNK_WIDTH - 2) * (CHUNK_WIDTH - 2);
+    print_result(run_benchmark("visibility pass switch", "voxels", [&]() {
+        benchmark_sink += visible_voxels(ids.data(), see_through_switch);
+        return voxels;
+    }));
+    print_result(run_benchmark("visibility pass registry comparisons", "voxels", [&]() {
+        benchmark_sink += visible_voxels(ids.data(), Materials::see_through);
+        return voxels;
+    }));
+    chunk.dispose();
+}
\ No newline at end of file
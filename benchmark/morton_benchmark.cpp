@@ -0,0 +1,160 @@
+#include <vector>
+#include <random>
+
+#include "./benchmark.h"
+#include "../class/utility/math/morton.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/chunk.h"
+
+#define MORTON_BENCH_COUNT 4096
+
+std::string kernel_name(MortonKernel kernel) {
+    switch (kernel)
+    {
+    case MortonKernel::Table: return "table";
+    case MortonKernel::BMI2: return "bmi2";
+    default: return "?";
+    }
+}
+
+// the usual shift and mask interleave, the reference of the table lookup
+uint32_t spread_magic(uint32_t v) {
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v << 8)) & 0x0300f00f;
+    v = (v | (v << 4)) & 0x030c30c3;
+    v = (v | (v << 2)) & 0x09249249;
+    return v;
+}
+uint32_t encode_magic(uint32_t x, uint32_t y, uint32_t z) {
+    return (spread_magic(x) << 2) | (spread_magic(y) << 1) | spread_magic(z);
+}
+
+void run_morton_benchmarks() {
+    std::mt19937 random = std::mt19937(1);
+    std::uniform_int_distribution<int> coordinate = std::uniform_int_distribution<int>(0, (1 << MORTON_AXIS_BITS) - 1);
+    std::uniform_int_distribution<int> voxel = std::uniform_int_distribution<int>(0, CHUNK_WIDTH - 1);
+
+    std::vector<int> x, y, z;
+    for (int i = 0; i < MORTON_BENCH_COUNT; i++)
+    {
+        x.push_back(coordinate(random));
+        y.push_back(coordinate(random));
+        z.push_back(coordinate(random));
+    }
+    std::vector<uint32_t> codes = std::vector<uint32_t>(MORTON_BENCH_COUNT);
+    std::vector<int> decoded_x = std::vector<int>(MORTON_BENCH_COUNT);
+    std::vector<int> decoded_y = std::vector<int>(MORTON_BENCH_COUNT);
+    std::vector<int> decoded_z = std::vector<int>(MORTON_BENCH_COUNT);
+
+    #pragma region single code
+    print_result(run_benchmark("morton encode shift and mask", "codes", [&]() {
+        uint32_t sum = 0;
+        for (int i = 0; i < MORTON_BENCH_COUNT; i++) sum += encode_magic(x[i], y[i], z[i]);
+        benchmark_sink += sum;
+        return MORTON_BENCH_COUNT;
+    }));
+    print_result(run_benchmark("morton encode table", "codes", [&]() {
+        uint32_t sum = 0;
+        for (int i = 0; i < MORTON_BENCH_COUNT; i++) sum += Morton::encode(x[i], y[i], z[i]);
+        benchmark_sink += sum;
+        return MORTON_BENCH_COUNT;
+    }));
+    for (int i = 0; i < MORTON_BENCH_COUNT; i++) codes[i] = Morton::encode(x[i], y[i], z[i]);
+    print_result(run_benchmark("morton decode table", "codes", [&]() {
+        int sum = 0;
+        for (uint32_t code : codes)
+        {
+            Vector3Int pos = Morton::decode(code);
+            sum += pos.x + pos.y + pos.z;
+        }
+        benchmark_sink += sum;
+        return MORTON_BENCH_COUNT;
+    }));
+    #pragma endregion
+
+    #pragma region batch
+    print_result(run_benchmark("morton batch encode", "codes", [&]() {
+        Morton::encode(&x[0], &y[0], &z[0], &codes[0], MORTON_BENCH_COUNT);
+        benchmark_sink += codes[0];
+        return MORTON_BENCH_COUNT;
+    }));
+
+    MortonKernel best_kernel = Morton::get_kernel();
+    MortonKernel kernels[] = { MortonKernel::Table, MortonKernel::BMI2 };
+    for (MortonKernel kernel : kernels)
+    {
+        if (!Morton::set_kernel(kernel)) continue;
+
+        // every kernel has to match the single code functions
+        unsigned int mismatches = 0;
+        Morton::encode(&x[0], &y[0], &z[0], &codes[0], MORTON_BENCH_COUNT);
+        Morton::decode(&codes[0], &decoded_x[0], &decoded_y[0], &decoded_z[0], MORTON_BENCH_COUNT);
+        for (int i = 0; i < MORTON_BENCH_COUNT; i++)
+        {
+            if (codes[i] != encode_magic(x[i], y[i], z[i])) mismatches++;
+            if (decoded_x[i] != x[i] || decoded_y[i] != y[i] || decoded_z[i] != z[i]) mismatches++;
+        }
+        if (mismatches != 0) std::cout << "WARNING: morton " << kernel_name(kernel) << " kernel is wrong on " << mismatches << " codes\n";
+        record_value({ "morton " + kernel_name(kernel) + " mismatches", "codes", (double)mismatches });
+
+        print_result(run_benchmark("morton batch decode " + kernel_name(kernel), "codes", [&]() {
+            Morton::decode(&codes[0], &decoded_x[0], &decoded_y[0], &decoded_z[0], MORTON_BENCH_COUNT);
+            benchmark_sink += decoded_x[0];
+            return MORTON_BENCH_COUNT;
+        }));
+    }
+    Morton::set_kernel(best_kernel);
+    #pragma endregion
+
+    #pragma region chunk
+    // the surface chunk, its cells in morton order against the same values in the cells[x][y][z] layout
+    WorldGenerator generator = WorldGenerator(1, 1, true);
+    Chunk chunk;
+    chunk.generate(generator, Vector3Int(0, 0, -1), CHUNK_RESOLUTION);
+
+    Cell*** nested = new Cell**[CHUNK_WIDTH];
+    for (int i = 0; i < CHUNK_WIDTH; i++) {
+        nested[i] = new Cell*[CHUNK_WIDTH];
+        for (int j = 0; j < CHUNK_WIDTH; j++) {
+            nested[i][j] = new Cell[CHUNK_WIDTH];
+            for (int k = 0; k < CHUNK_WIDTH; k++) nested[i][j][k].value = chunk.get(Vector3Int(i, j, k));
+        }
+    }
+    std::vector<Vector3Int> voxels;
+    for (int i = 0; i < MORTON_BENCH_COUNT; i++) voxels.push_back(Vector3Int(voxel(random), voxel(random), voxel(random)));
+
+    print_result(run_benchmark("chunk random get nested arrays", "voxels", [&]() {
+        unsigned int sum = 0;
+        for (Vector3Int& pos : voxels) sum += nested[pos.x][pos.y][pos.z].value;
+        benchmark_sink += sum;
+        return MORTON_BENCH_COUNT;
+    }));
+    Cell* cells = chunk.get_storage()->cells;
+    print_result(run_benchmark("chunk random get morton cells", "voxels", [&]() {
+        unsigned int sum = 0;
+        for (Vector3Int& pos : voxels) sum += cells[Morton::encode(pos)].value;
+        benchmark_sink += sum;
+        return MORTON_BENCH_COUNT;
+    }));
+    print_result(run_benchmark("chunk random get Chunk::safe_get", "voxels", [&]() {
+        unsigned int sum = 0;
+        for (Vector3Int& pos : voxels) sum += chunk.safe_get(pos);
+        benchmark_sink += sum;
+        return MORTON_BENCH_COUNT;
+    }));
+    print_result(run_benchmark("chunk flatten", "chunks", [&]() {
+        // setting a voxel to its own value only marks the flatten data outdated
+        chunk.set(Vector3Int(0, 0, 0), chunk.get(Vector3Int(0, 0, 0)));
+        benchmark_sink += chunk.flatten()->size();
+        return 1;
+    }));
+
+    for (int i = 0; i < CHUNK_WIDTH; i++) {
+        for (int j = 0; j < CHUNK_WIDTH; j++) delete[] nested[i][j];
+        delete[] nested[i];
+    }
+    delete[] nested;
+    chunk.dispose();
+    #pragma endregion
+}
\ No newline at end of file
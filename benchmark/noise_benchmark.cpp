@@ -0,0 +1,82 @@
+#include <vector>
+#include <cstring>
+
+#include "./benchmark.h"
+#include "../class/utility/math/noise.h"
+
+#define NOISE_SAMPLES 4096
+
+std::string kernel_name(NoiseKernel kernel) {
+    switch (kernel)
+    {
+    case NoiseKernel::SSE4: return "sse4";
+    case NoiseKernel::AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+std::string type_name(NoiseType type) {
+    switch (type)
+    {
+    case NoiseType::Value: return "value";
+    case NoiseType::Simplex: return "simplex";
+    default: return "perlin";
+    }
+}
+
+// returns the batched samples that differ from the scalar reference
+unsigned int run_noise_benchmarks() {
+    std::vector<float> x = std::vector<float>(NOISE_SAMPLES);
+    std::vector<float> y = std::vector<float>(NOISE_SAMPLES);
+    std::vector<float> z = std::vector<float>(NOISE_SAMPLES);
+    std::vector<float> out = std::vector<float>(NOISE_SAMPLES);
+    for (int i = 0; i < NOISE_SAMPLES; i++)
+    {
+        x[i] = (i % 64) * 0.37f - 11;
+        y[i] = (i / 64) * 0.53f + 7;
+        z[i] = (i % 13) * 1.1f - 5;
+    }
+
+    NoiseKernel best_kernel = Noise::get_kernel();
+    NoiseType types[] = { NoiseType::Value, NoiseType::Perlin, NoiseType::Simplex };
+    NoiseKernel kernels[] = { NoiseKernel::Scalar, NoiseKernel::SSE4, NoiseKernel::AVX2 };
+    unsigned int total_mismatches = 0;
+
+    for (NoiseType type : types)
+    for (NoiseKernel kernel : kernels)
+    {
+        if (!Noise::set_kernel(kernel)) continue;
+        Noise noise = Noise(1, type, 1, 1);
+
+        // every kernel has to match the scalar reference exactly, in 2D (the terrain) and in 3D (the caves)
+        unsigned int mismatches = 0;
+        noise.sample(&x[0], &y[0], &out[0], NOISE_SAMPLES);
+        for (int i = 0; i < NOISE_SAMPLES; i++)
+        {
+            float reference = noise.sample(x[i], y[i]);
+            if (memcmp(&reference, &out[i], sizeof(float)) != 0) mismatches++;
+        }
+        noise.sample(&x[0], &y[0], &z[0], &out[0], NOISE_SAMPLES);
+        for (int i = 0; i < NOISE_SAMPLES; i++)
+        {
+            float reference = noise.sample(x[i], y[i], z[i]);
+            if (memcmp(&reference, &out[i], sizeof(float)) != 0) mismatches++;
+        }
+        if (mismatches != 0) std::cout << "ERROR: " << kernel_name(kernel) << " " << type_name(type) << " differs from the scalar reference on " << mismatches << " samples\n";
+        record_value({ "noise " + type_name(type) + " " + kernel_name(kernel) + " mismatches", "samples", (double)mismatches });
+        total_mismatches += mismatches;
+
+        print_result(run_benchmark("noise 2D " + type_name(type) + " " + kernel_name(kernel), "samples", [&]() {
+            noise.sample(&x[0], &y[0], &out[0], NOISE_SAMPLES);
+            benchmark_sink += out[0] > 0;
+            return NOISE_SAMPLES;
+        }));
+        print_result(run_benchmark("noise 3D " + type_name(type) + " " + kernel_name(kernel), "samples", [&]() {
+            noise.sample(&x[0], &y[0], &z[0], &out[0], NOISE_SAMPLES);
+            benchmark_sink += out[0] > 0;
+            return NOISE_SAMPLES;
+        }));
+    }
+
+    Noise::set_kernel(best_kernel);
+    return total_mismatches;
+}
@@ -0,0 +1,66 @@
+#include "./benchmark.h"
+#include "../class/world/generator_pipeline.h"
+
+#define PIPELINE_BENCH_RADIUS 1
+
+void run_pipeline_benchmarks() {
+    WorldGenerator generator = WorldGenerator(1, 1, true);
+
+    Cell*** cells = new Cell**[CHUNK_WIDTH];
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+        cells[x] = new Cell*[CHUNK_WIDTH];
+        for (int y = 0; y < CHUNK_WIDTH; y++) cells[x][y] = new Cell[CHUNK_WIDTH];
+    }
+
+    auto all_chunks = [&](auto generate) {
+        unsigned int voxels = 0;
+        for (int x = -PIPELINE_BENCH_RADIUS; x <= PIPELINE_BENCH_RADIUS; x++)
+        for (int y = -PIPELINE_BENCH_RADIUS; y <= PIPELINE_BENCH_RADIUS; y++)
+        for (int z = -PIPELINE_BENCH_RADIUS; z <= PIPELINE_BENCH_RADIUS; z++)
+        {
+            for (int i = 0; i < CHUNK_WIDTH; i++)
+            for (int j = 0; j < CHUNK_WIDTH; j++)
+                std::fill(cells[i][j], cells[i][j] + CHUNK_WIDTH, Cell());
+
+            GenerationContext context = GenerationContext(cells, Vector3Int(x, y, z) * CHUNK_WIDTH, CHUNK_WIDTH);
+            generate(context);
+            benchmark_sink += cells[0][0][0].value;
+            voxels += CHUNK_WIDTH * CHUNK_WIDTH * CHUNK_WIDTH;
+        }
+        return voxels;
+    };
+
+    // same stages as WorldGenerator::generate_chunk with caves, plus a decorator
+    auto pipeline = make_pipeline(HeightmapStage(generator), StrataStage(), CaveStage(generator), WaterStage(), SeabedDecorator());
+    RuntimePipeline runtime_pipeline;
+    runtime_pipeline.add_stage(HeightmapStage(generator));
+    runtime_pipeline.add_stage(StrataStage());
+    runtime_pipeline.add_stage(CaveStage(generator));
+    runtime_pipeline.add_stage(WaterStage());
+    runtime_pipeline.add_stage(SeabedDecorator());
+
+    print_result(run_benchmark("GeneratorPipeline fused", "voxels", [&]() {
+        return all_chunks([&](GenerationContext& context) { pipeline.generate(context); });
+    }));
+    print_result(run_benchmark("RuntimePipeline", "voxels", [&]() {
+        return all_chunks([&](GenerationContext& context) { runtime_pipeline.generate(context); });
+    }));
+
+    StageTimings timings;
+    print_result(run_benchmark("GeneratorPipeline timed", "voxels", [&]() {
+        return all_chunks([&](GenerationContext& context) { pipeline.generate_timed(context, timings); });
+    }));
+    timings.print();
+
+    StageTimings runtime_timings;
+    print_result(run_benchmark("RuntimePipeline timed", "voxels", [&]() {
+        return all_chunks([&](GenerationContext& context) { runtime_pipeline.generate_timed(context, runtime_timings); });
+    }));
+    runtime_timings.print();
+
+    for (int x = 0; x < CHUNK_WIDTH; x++) {
+        for (int y = 0; y < CHUNK_WIDTH; y++) delete[] cells[x][y];
+        delete[] cells[x];
+    }
+    delete[] cells;
+}
\ No newline at end of file
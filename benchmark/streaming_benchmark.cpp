@@ -0,0 +1,126 @@
+#include <vector>
+
+#include "./benchmark.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/world.h"
+#include "../class/world/chunk.h"
+#include "../class/utility/graphics/buffer_device.h"
+
+#define STREAMING_RADIUS 3
+#define STREAMING_DATA_BINDING 0
+#define STREAMING_INDEX_BINDING 1
+
+// what a frame cost on the device
+void print_frames(std::string name, DeviceStats stats, unsigned int frames) {
+    frames = __max(1U, frames);
+    std::cout << name << ": "
+        << frames << " frames, "
+        << (double)stats.calls / frames << " calls/frame, "
+        << (double)stats.bytes_uploaded / frames / 1024 << " KB uploaded/frame, "
+        << (double)stats.bytes_copied / frames / 1024 << " KB copied/frame, "
+        << (double)stats.bytes_allocated / 1024 << " KB allocated\n";
+
+    record_value({ name + " calls", "calls/frame", (double)stats.calls / frames });
+    record_value({ name + " uploaded", "KB/frame", (double)stats.bytes_uploaded / frames / 1024 });
+    record_value({ name + " copied", "KB/frame", (double)stats.bytes_copied / frames / 1024 });
+    record_value({ name + " allocated", "KB", (double)stats.bytes_allocated / 1024 });
+}
+
+// chunks whose data in the device buffers is not their flatten data
+unsigned int check_streamed_data(World& world, MockBufferDevice& device) {
+    std::vector<char>* indexes = device.get_data(device.get_binding(STREAMING_INDEX_BINDING));
+    std::vector<char>* data = device.get_data(device.get_binding(STREAMING_DATA_BINDING));
+    if (indexes == nullptr || data == nullptr) return 1;
+
+    unsigned int mismatches = 0;
+    for (int x = -STREAMING_RADIUS; x <= STREAMING_RADIUS; x++)
+    for (int y = -STREAMING_RADIUS; y <= STREAMING_RADIUS; y++)
+    for (int z = -STREAMING_RADIUS; z <= STREAMING_RADIUS; z++)
+    {
+        Chunk* chunk = world.get_chunk(x, y, z);
+        std::vector<GPUCell>* cells = chunk->flatten();
+
+        // root index of the chunk in the data buffer + GPU_CELL_UNUSED_OFFSET, 0 without data
+        unsigned int root = 0;
+        if ((chunk->GPU_index + 1) * sizeof(unsigned int) > indexes->size()) {
+            mismatches++;
+            continue;
+        }
+        memcpy(&root, &(*indexes)[chunk->GPU_index * sizeof(unsigned int)], sizeof(unsigned int));
+
+        if (cells == nullptr || cells->empty()) {
+            if (root != 0) mismatches++;
+            continue;
+        }
+        unsigned long long offset = (unsigned long long)(root - GPU_CELL_UNUSED_OFFSET) * CELL_MEMORY_SIZE;
+        unsigned long long size = cells->size() * CELL_MEMORY_SIZE;
+        if (root == 0 || offset + size > data->size() || memcmp(&(*data)[offset], &(*cells)[0], size) != 0) mismatches++;
+    }
+    return mismatches;
+}
+// report the chunks streamed wrong after a phase, returns their number
+unsigned int print_check(std::string name, World& world, MockBufferDevice& device) {
+    unsigned int mismatches = check_streamed_data(world, device);
+    if (mismatches != 0) std::cout << "ERROR: " << name << ": " << mismatches << " chunks differ from their flatten data\n";
+    record_value({ name + " mismatches", "chunks", (double)mismatches });
+    return mismatches;
+}
+
+// world streaming against the mock device, no OpenGL context needed
+// returns the device errors plus the chunks whose buffer data differs from their flatten data
+unsigned int run_streaming_benchmarks() {
+    MockBufferDevice device;
+    device.record_calls = false;
+
+    WorldGenerator generator = WorldGenerator(1);
+    World world = World(STREAMING_RADIUS, &generator);
+    world.create_buffer(STREAMING_DATA_BINDING, STREAMING_INDEX_BINDING, &device);
+    world.send_data();
+    device.reset_stats();
+
+    // first load, one update and one upload per frame like the simulation and the render thread
+    unsigned int frames = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (!world.is_loaded()) {
+        world.update(0);
+        world.upload_pending();
+        frames++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    print_frames("streaming load radius " + std::to_string(STREAMING_RADIUS), device.stats, frames);
+    std::cout << "    " << elapsed.count() * 1000 / __max(1U, frames) << " ms/frame\n";
+    record_value({ "streaming load radius " + std::to_string(STREAMING_RADIUS) + " time", "ms/frame", elapsed.count() * 1000 / __max(1U, frames) });
+    unsigned int mismatches = print_check("streaming load radius " + std::to_string(STREAMING_RADIUS), world, device);
+
+    // editing far chunks regenerates them at full resolution: the lod switch grows their data in place
+    device.reset_stats();
+    frames = 0;
+    for (int x = STREAMING_RADIUS - 1; x <= STREAMING_RADIUS; x++)
+    for (int y = 0; y <= STREAMING_RADIUS; y++)
+    {
+        world.update(0);
+        world.set(Vector3Int(x, y, 0) * CHUNK_WIDTH + Vector3Int(1, 1, 1), MATERIAL_AIR);
+        world.upload_pending();
+        frames++;
+    }
+    print_frames("streaming lod switch", device.stats, frames);
+    mismatches += print_check("streaming lod switch", world, device);
+
+    // small edit of an already full resolution chunk
+    device.reset_stats();
+    frames = 0;
+    for (int i = 0; i < CHUNK_WIDTH; i++)
+    {
+        world.update(0);
+        world.set(Vector3Int(i, i, 1), MATERIAL_AIR);
+        world.upload_pending();
+        frames++;
+    }
+    print_frames("streaming edit", device.stats, frames);
+    mismatches += print_check("streaming edit", world, device);
+
+    std::cout << "    " << device.get_buffer_count() << " buffers alive, " << device.errors << " device errors\n";
+    record_value({ "streaming device errors", "errors", (double)device.errors });
+    world.dispose();
+    return device.errors + mismatches;
+}
\ No newline at end of file
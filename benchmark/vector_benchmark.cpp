@@ -0,0 +1,106 @@
+#include <vector>
+#include <random>
+
+#include "./benchmark.h"
+#include "../class/utility/math/vector3.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/world.h"
+
+#define VECTOR_BENCH_COUNT 4096
+#define VECTOR_BENCH_RADIUS 2
+#define VECTOR_BENCH_RAY_LENGTH 200
+
+// the math World::get_next_cell does for each cell crossed, without the world lookup
+Vector3Int next_cell_math(Vector3 position, Vector3 direction, unsigned int cell_size) {
+    Vector3 pos_in_cell = (position / cell_size) % 1;
+    float step_size = 3;
+    Vector3 cell_jump = Vector3(0, 0, 0);
+    for (int i = 0; i < 3; i++)
+    {
+        float temp = 3;
+        if (direction[i] > 0) temp = (1 - pos_in_cell[i]) / direction[i];
+        else if (direction[i] < 0) temp = -pos_in_cell[i] / direction[i];
+
+        if (temp < step_size) {
+            step_size = temp;
+            cell_jump = Vector3(0, 0, 0);
+            cell_jump[i] = (direction[i] > 0) - (direction[i] < 0);
+        }
+    }
+    position += direction * step_size * cell_size;
+    return (position + cell_jump * 0.1).floor();
+}
+
+void run_vector_benchmarks() {
+    std::mt19937 random = std::mt19937(1);
+    std::uniform_real_distribution<float> coordinate = std::uniform_real_distribution<float>(-VECTOR_BENCH_RADIUS * CHUNK_WIDTH, VECTOR_BENCH_RADIUS * CHUNK_WIDTH);
+    std::uniform_real_distribution<float> unit = std::uniform_real_distribution<float>(-1, 1);
+
+    std::vector<Vector3> positions, directions;
+    for (int i = 0; i < VECTOR_BENCH_COUNT; i++)
+    {
+        positions.push_back(Vector3(coordinate(random), coordinate(random), coordinate(random) * 0.5f + CHUNK_WIDTH));
+        directions.push_back(Vector3(unit(random), unit(random), unit(random)).normalized());
+    }
+
+    // one floorf call per component against the sse2 floor of Vector3::floor
+    print_result(run_benchmark("floorf per component", "vectors", [&]() {
+        for (Vector3& position : positions)
+        {
+            Vector3Int cell = Vector3Int(floorf(position.x), floorf(position.y), floorf(position.z));
+            benchmark_sink += cell.x + cell.y + cell.z;
+        }
+        return VECTOR_BENCH_COUNT;
+    }));
+    print_result(run_benchmark("Vector3::floor", "vectors", [&]() {
+        for (Vector3& position : positions)
+        {
+            Vector3Int cell = position.floor();
+            benchmark_sink += cell.x + cell.y + cell.z;
+        }
+        return VECTOR_BENCH_COUNT;
+    }));
+    print_result(run_benchmark("Vector3Int arithmetic", "vectors", [&]() {
+        Vector3Int total = Vector3Int(0, 0, 0);
+        for (Vector3& position : positions)
+        {
+            Vector3Int cell = position.floor();
+            total += (cell - Vector3Int(1, 2, 3)) * CHUNK_WIDTH / 2 % CHUNK_WIDTH;
+        }
+        benchmark_sink += total.x + total.y + total.z;
+        return VECTOR_BENCH_COUNT;
+    }));
+
+    // the hot loop of the raycasts: without the world, then through World::raycast
+    print_result(run_benchmark("raycast cell step math", "cells", [&]() {
+        for (int i = 0; i < VECTOR_BENCH_COUNT; i++)
+        {
+            Vector3Int cell = next_cell_math(positions[i], directions[i], 1);
+            benchmark_sink += cell.x + cell.y + cell.z;
+        }
+        return VECTOR_BENCH_COUNT;
+    }));
+
+    WorldGenerator generator = WorldGenerator(1);
+    World world = World(VECTOR_BENCH_RADIUS, &generator);
+    while (!world.is_loaded()) world.update(0);
+
+    print_result(run_benchmark("World::raycast", "rays", [&]() {
+        for (int i = 0; i < VECTOR_BENCH_COUNT; i++)
+        {
+            RaycastHit hit = world.raycast(positions[i], directions[i], VECTOR_BENCH_RAY_LENGTH);
+            benchmark_sink += hit.cell_value;
+        }
+        return VECTOR_BENCH_COUNT;
+    }));
+    print_result(run_benchmark("World::raycast_down", "rays", [&]() {
+        for (int i = 0; i < VECTOR_BENCH_COUNT; i++)
+        {
+            RaycastHit hit = world.raycast_down(positions[i], VECTOR_BENCH_RAY_LENGTH);
+            benchmark_sink += hit.cell_value;
+        }
+        return VECTOR_BENCH_COUNT;
+    }));
+
+    world.dispose();
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <vector>
+#include <random>
+
+#include "./benchmark.h"
+#include "../class/world/world_generator.h"
+#include "../class/world/world.h"
+#include "../class/world/chunk.h"
+#include "../class/utility/graphics/buffer_device.h"
+
+#define WORLD_BENCH_RADIUS 2
+#define WORLD_BENCH_LOOKUPS 4096
+#define WORLD_BENCH_DATA_BINDING 0
+#define WORLD_BENCH_INDEX_BINDING 1
+
+// the chunks, their flatten and the world as the simulation and the render thread use them, no OpenGL context needed
+void run_world_benchmarks() {
+    WorldGenerator generator = WorldGenerator(1);
+
+    // a cube of chunks across the surface: sky, surface and ground
+    std::vector<Vector3Int> chunk_positions;
+    for (int x = -1; x <= 1; x++)
+    for (int y = -1; y <= 1; y++)
+    for (int z = -1; z <= 1; z++)
+        chunk_positions.push_back(Vector3Int(x, y, z));
+
+    #pragma region chunk
+    for (int lod = CHUNK_RESOLUTION; lod >= CHUNK_RESOLUTION - 2; lod--)
+    {
+        print_result(run_benchmark("Chunk::generate lod " + std::to_string(lod), "chunks", [&]() {
+            for (Vector3Int& chunk_pos : chunk_positions)
+            {
+                Chunk chunk;
+                chunk.generate(generator, chunk_pos, lod);
+                benchmark_sink += chunk.flatten()->size();
+                chunk.dispose();
+            }
+            return chunk_positions.size();
+        }));
+    }
+
+    // full resolution chunks flattened down to each lod, as the world does for far chunks
+    std::vector<Chunk> chunks = std::vector<Chunk>(chunk_positions.size());
+    for (unsigned int i = 0; i < chunks.size(); i++) chunks[i].generate(generator, chunk_positions[i], CHUNK_RESOLUTION);
+
+    for (int lod = CHUNK_RESOLUTION; lod >= 0; lod--)
+    {
+        unsigned int cells = 0;
+        BenchmarkResult result = run_benchmark("Chunk::flatten lod " + std::to_string(lod), "chunks", [&]() {
+            cells = 0;
+            for (Chunk& chunk : chunks)
+            {
+                // setting a voxel to its own value only marks the flatten data outdated
+                chunk.set(Vector3Int(0, 0, 0), chunk.get(Vector3Int(0, 0, 0)));
+                cells += chunk.flatten(lod)->size();
+            }
+            benchmark_sink += cells;
+            return chunks.size();
+        });
+        print_result(result);
+        print_value({ "Chunk::flatten lod " + std::to_string(lod) + " size", "cells/chunk", (double)cells / chunks.size() });
+    }
+    for (Chunk& chunk : chunks) chunk.dispose();
+    #pragma endregion
+
+    #pragma region world
+    MockBufferDevice device;
+    device.record_calls = false;
+
+    World world = World(WORLD_BENCH_RADIUS, &generator);
+    world.create_buffer(WORLD_BENCH_DATA_BINDING, WORLD_BENCH_INDEX_BINDING, &device);
+    world.send_data();
+    while (!world.is_loaded()) {
+        world.update(0);
+        world.upload_pending();
+    }
+
+    std::mt19937 random = std::mt19937(1);
+    std::uniform_int_distribution<int> coordinate = std::uniform_int_distribution<int>(-WORLD_BENCH_RADIUS * CHUNK_WIDTH + 1, WORLD_BENCH_RADIUS * CHUNK_WIDTH - 1);
+    std::vector<Vector3Int> voxels;
+    for (int i = 0; i < WORLD_BENCH_LOOKUPS; i++) voxels.push_back(Vector3Int(coordinate(random), coordinate(random), coordinate(random)));
+    // a whole chunk in x / y / z order, like the collision sweeps and the player checks
+    std::vector<Vector3Int> scan;
+    for (int x = 0; x < CHUNK_WIDTH; x++)
+    for (int y = 0; y < CHUNK_WIDTH; y++)
+    for (int z = -CHUNK_WIDTH; z < 0; z++)
+        scan.push_back(Vector3Int(x, y, z));
+
+    print_result(run_benchmark("World::get random", "voxels", [&]() {
+        unsigned int sum = 0;
+        for (Vector3Int& voxel : voxels) sum += world.get(voxel);
+        benchmark_sink += sum;
+        return WORLD_BENCH_LOOKUPS;
+    }));
+    print_result(run_benchmark("World::get chunk scan", "voxels", [&]() {
+        unsigned int sum = 0;
+        for (Vector3Int& voxel : scan) sum += world.get(voxel);
+        benchmark_sink += sum;
+        return scan.size();
+    }));
+
+    // an edit per frame: the chunk is flattened again, staged and copied by upload_pending
+    device.reset_stats();
+    unsigned int edits = 0;
+    print_result(run_benchmark("World::set and upload_pending", "edits", [&]() {
+        Vector3Int voxel = Vector3Int(edits % CHUNK_WIDTH, (edits / CHUNK_WIDTH) % CHUNK_WIDTH, -1);
+        world.set(voxel, (edits / (CHUNK_WIDTH * CHUNK_WIDTH)) % 2 == 0 ? MATERIAL_AIR : MATERIAL_STONE);
+        world.upload_pending();
+        edits++;
+        return 1;
+    }));
+    print_value({ "World::set and upload_pending calls", "calls/edit", (double)device.stats.calls / __max(1U, edits) });
+    print_value({ "World::set and upload_pending uploaded", "KB/edit", (double)device.stats.bytes_uploaded / __max(1U, edits) / 1024 });
+    print_value({ "World::set and upload_pending copied", "KB/edit", (double)device.stats.bytes_copied / __max(1U, edits) / 1024 });
+    if (device.errors != 0) std::cout << "WARNING: " << device.errors << " device errors\n";
+    record_value({ "World::set and upload_pending device errors", "errors", (double)device.errors });
+
+    world.dispose();
+    #pragma endregion
+}
\ No newline at end of file
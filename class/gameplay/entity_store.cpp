@@ -0,0 +1,212 @@
+#ifndef _ENTITY_STORE_CLASS
+
+#include "./entity_store.h"
+
+EntityStore::EntityStore(World* world, JobSystem* jobs) {
+    this->world = world;
+    this->jobs = jobs;
+}
+
+EntityId EntityStore::spawn(Vector3 position, Vector3 velocity, Vector3 extent, unsigned int components) {
+    unsigned int index = this->components.size();
+    for (int axis = 0; axis < 3; axis++)
+    {
+        this->position[axis].push_back(position[axis]);
+        this->velocity[axis].push_back(velocity[axis]);
+        this->extent[axis].push_back(extent[axis]);
+    }
+    this->components.push_back(components & ~ENTITY_ON_GROUND);
+
+    EntityId id;
+    if (!this->free_slots.empty()) {
+        id.slot = this->free_slots.back();
+        this->free_slots.pop_back();
+        this->entity_of[id.slot] = index;
+    }
+    else {
+        id.slot = this->entity_of.size();
+        this->entity_of.push_back(index);
+        this->generations.push_back(0);
+    }
+    id.generation = this->generations[id.slot];
+    this->slot_of.push_back(id.slot);
+    return id;
+}
+bool EntityStore::remove(EntityId id) {
+    int index = this->get_index(id);
+    if (index < 0) return false;
+
+    // the last entity takes the place of the removed one
+    unsigned int last = this->components.size() - 1;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        this->position[axis][index] = this->position[axis][last];
+        this->velocity[axis][index] = this->velocity[axis][last];
+        this->extent[axis][index] = this->extent[axis][last];
+        this->position[axis].pop_back();
+        this->velocity[axis].pop_back();
+        this->extent[axis].pop_back();
+    }
+    this->components[index] = this->components[last];
+    this->components.pop_back();
+    this->slot_of[index] = this->slot_of[last];
+    this->slot_of.pop_back();
+    if (index != last) this->entity_of[this->slot_of[index]] = index;
+
+    this->generations[id.slot]++;
+    this->free_slots.push_back(id.slot);
+    return true;
+}
+void EntityStore::clear() {
+    for (int axis = 0; axis < 3; axis++)
+    {
+        this->position[axis].clear();
+        this->velocity[axis].clear();
+        this->extent[axis].clear();
+    }
+    this->components.clear();
+    for (unsigned int slot : this->slot_of)
+    {
+        this->generations[slot]++;
+        this->free_slots.push_back(slot);
+    }
+    this->slot_of.clear();
+}
+int EntityStore::get_index(EntityId id) {
+    if (id.slot >= this->generations.size() || this->generations[id.slot] != id.generation) return -1;
+    return this->entity_of[id.slot];
+}
+bool EntityStore::is_alive(EntityId id) {
+    return this->get_index(id) >= 0;
+}
+unsigned int EntityStore::get_count() {
+    return this->components.size();
+}
+
+Vector3 EntityStore::get_position(EntityId id) {
+    int index = this->get_index(id);
+    if (index < 0) return Vector3(0, 0, 0);
+    return Vector3(this->position[0][index], this->position[1][index], this->position[2][index]);
+}
+Vector3 EntityStore::get_velocity(EntityId id) {
+    int index = this->get_index(id);
+    if (index < 0) return Vector3(0, 0, 0);
+    return Vector3(this->velocity[0][index], this->velocity[1][index], this->velocity[2][index]);
+}
+void EntityStore::set_velocity(EntityId id, Vector3 velocity) {
+    int index = this->get_index(id);
+    if (index < 0) return;
+    for (int axis = 0; axis < 3; axis++) this->velocity[axis][index] = velocity[axis];
+    this->components[index] &= ~ENTITY_ON_GROUND;
+}
+unsigned int EntityStore::get_components(EntityId id) {
+    int index = this->get_index(id);
+    if (index < 0) return 0;
+    return this->components[index];
+}
+
+void EntityStore::update(float deltatime) {
+    unsigned int count = this->components.size();
+    // each batch only writes its own entities, the world is only read: no lock
+    this->jobs->parallel_for(count, ENTITY_BATCH_SIZE, [&](unsigned int begin, unsigned int end) { this->gravity_system(begin, end, deltatime); });
+    this->jobs->parallel_for(count, ENTITY_BATCH_SIZE, [&](unsigned int begin, unsigned int end) { this->movement_system(begin, end, deltatime); });
+    this->jobs->parallel_for(count, ENTITY_BATCH_SIZE, [&](unsigned int begin, unsigned int end) { this->collision_system(begin, end, deltatime); });
+}
+
+#pragma region systems
+void EntityStore::gravity_system(unsigned int begin, unsigned int end, float deltatime) {
+    const unsigned int* components = &this->components[0];
+    float* velocity_z = &this->velocity[2][0];
+    // branchless so the loop vectorizes
+    for (unsigned int i = begin; i < end; i++)
+    {
+        float falling = __max(velocity_z[i] - ENTITY_GRAVITY_ACCELERATION * deltatime, -ENTITY_MAX_FALL_SPEED);
+        velocity_z[i] = (components[i] & ENTITY_GRAVITY) ? falling : velocity_z[i];
+    }
+}
+void EntityStore::movement_system(unsigned int begin, unsigned int end, float deltatime) {
+    const unsigned int* components = &this->components[0];
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float* position = &this->position[axis][0];
+        const float* velocity = &this->velocity[axis][0];
+        for (unsigned int i = begin; i < end; i++)
+        {
+            // colliders move in collision_system
+            bool moves = (components[i] & (ENTITY_VELOCITY | ENTITY_COLLIDER)) == ENTITY_VELOCITY;
+            position[i] += (moves ? velocity[i] : 0.0f) * deltatime;
+        }
+    }
+}
+void EntityStore::collision_system(unsigned int begin, unsigned int end, float deltatime) {
+    // z first: an entity on the ground slides along x and y without catching on the voxels under it
+    static const int axis_order[3] = { 2, 0, 1 };
+
+    for (unsigned int i = begin; i < end; i++)
+    {
+        if ((this->components[i] & (ENTITY_VELOCITY | ENTITY_COLLIDER)) != (ENTITY_VELOCITY | ENTITY_COLLIDER)) continue;
+
+        float box_min[3], box_max[3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            box_min[axis] = this->position[axis][i] - this->extent[axis][i];
+            box_max[axis] = this->position[axis][i] + this->extent[axis][i];
+        }
+
+        this->components[i] &= ~ENTITY_ON_GROUND;
+        for (int axis : axis_order)
+        {
+            float move = this->velocity[axis][i] * deltatime;
+            if (move == 0) continue;
+
+            float allowed = this->sweep(axis, box_min, box_max, move);
+            box_min[axis] += allowed;
+            box_max[axis] += allowed;
+            this->position[axis][i] += allowed;
+            if (allowed == move) continue;
+
+            this->velocity[axis][i] = 0;
+            if (axis == 2 && move < 0) this->components[i] |= ENTITY_ON_GROUND;
+        }
+    }
+}
+float EntityStore::sweep(int axis, const float* box_min, const float* box_max, float move) {
+    int axis_b = (axis + 1) % 3;
+    int axis_c = (axis + 2) % 3;
+    // voxels the box covers on the two other axes
+    int min_b = (int)floorf(box_min[axis_b]), max_b = (int)ceilf(box_max[axis_b]) - 1;
+    int min_c = (int)floorf(box_min[axis_c]), max_c = (int)ceilf(box_max[axis_c]) - 1;
+
+    // layers of voxels the leading face enters, nearest first
+    int first, last, step;
+    if (move > 0) {
+        first = (int)ceilf(box_max[axis]);
+        last = (int)ceilf(box_max[axis] + move) - 1;
+        step = 1;
+    }
+    else {
+        first = (int)floorf(box_min[axis]) - 1;
+        last = (int)floorf(box_min[axis] + move);
+        step = -1;
+    }
+
+    Vector3Int voxel;
+    for (int layer = first; (layer - last) * step <= 0; layer += step)
+    {
+        voxel[axis] = layer;
+        for (int b = min_b; b <= max_b; b++)
+        for (int c = min_c; c <= max_c; c++)
+        {
+            voxel[axis_b] = b;
+            voxel[axis_c] = c;
+            if (!Materials::is_solid(this->world->get(voxel))) continue;
+
+            if (move > 0) return __max(0.0f, layer - ENTITY_COLLISION_SKIN - box_max[axis]);
+            return __min(0.0f, layer + 1 + ENTITY_COLLISION_SKIN - box_min[axis]);
+        }
+    }
+    return move;
+}
+#pragma endregion
+
+#endif
\ No newline at end of file
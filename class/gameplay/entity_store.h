@@ -0,0 +1,78 @@
+#ifndef _ENTITY_STORE_CLASS
+#define _ENTITY_STORE_CLASS
+
+#include <vector>
+#include <cmath>
+
+#include "../utility/math/vector3.h"
+#include "../utility/thread/job_system.h"
+#include "../world/world.h"
+
+// components, an entity has the bits of the ones it uses
+#define ENTITY_VELOCITY     (1U << 0)   // moved by its velocity every tick
+#define ENTITY_GRAVITY      (1U << 1)   // its velocity falls
+#define ENTITY_COLLIDER     (1U << 2)   // its box is stopped by the solid voxels (needs ENTITY_VELOCITY)
+// set by the systems
+#define ENTITY_ON_GROUND    (1U << 3)
+
+#define ENTITY_GRAVITY_ACCELERATION 19.62f
+// terminal speed of a fall, also bounds the voxels a sweep visits per tick
+#define ENTITY_MAX_FALL_SPEED 60.0f
+// entities per job of the systems
+#define ENTITY_BATCH_SIZE 1024
+// gap kept between a box and the voxels it touches, so a box never starts a tick inside one
+#define ENTITY_COLLISION_SKIN 0.001f
+
+// stays valid while the entity lives, then never matches another one (the generation of its slot changed)
+struct EntityId
+{
+    unsigned int slot = 0;
+    unsigned int generation = 0;
+};
+
+// dynamic objects (mobs, projectiles, items) stored one array per component, index i of every array is the same entity
+// each system runs over the whole arrays once per tick, in batches spread on the job system
+// removing moves the last entity into the hole so the arrays stay dense
+class EntityStore
+{
+private:
+    World* world;
+    JobSystem* jobs;
+
+    // [axis][entity], the box is position +- extent
+    std::vector<float> position[3];
+    std::vector<float> velocity[3];
+    std::vector<float> extent[3];
+    std::vector<unsigned int> components;
+    // entity -> its slot, slot -> entity and generation
+    std::vector<unsigned int> slot_of;
+    std::vector<unsigned int> entity_of;
+    std::vector<unsigned int> generations;
+    std::vector<unsigned int> free_slots;
+
+    void gravity_system(unsigned int begin, unsigned int end, float deltatime);
+    void movement_system(unsigned int begin, unsigned int end, float deltatime);
+    void collision_system(unsigned int begin, unsigned int end, float deltatime);
+    // how far the box can go along axis before a solid voxel, the move clamped to it
+    float sweep(int axis, const float* box_min, const float* box_max, float move);
+    // -1 if the entity is dead
+    int get_index(EntityId id);
+public:
+    EntityStore(World* world, JobSystem* jobs);
+
+    EntityId spawn(Vector3 position, Vector3 velocity, Vector3 extent, unsigned int components);
+    bool remove(EntityId id);
+    void clear();
+    bool is_alive(EntityId id);
+    unsigned int get_count();
+
+    Vector3 get_position(EntityId id);
+    Vector3 get_velocity(EntityId id);
+    void set_velocity(EntityId id, Vector3 velocity);
+    unsigned int get_components(EntityId id);
+
+    // one tick of every system: gravity, then movement, then collisions with the world
+    void update(float deltatime);
+};
+
+#endif
\ No newline at end of file
@@ -2,9 +2,8 @@
 
 #include "./player.h"
 
-Player::Player(Vector3 position, Screen* screen, World* world) {
+Player::Player(Vector3 position, World* world) {
     this->position = position;
-    this->screen = screen;
     this->world = world;
 
     this->send_data();
@@ -18,17 +17,26 @@ Vector3 Player::get_direction() {
         sin(this->view_pitch)
         ).normalized();
 }
+const PlayerView& Player::get_view() {
+    return this->view;
+}
+unsigned int Player::get_cursor_raycasts() {
+    return this->cursor_raycasts;
+}
+unsigned int Player::get_picks_used() {
+    return this->picks_used;
+}
 void Player::send_data() {
-    this->screen->set_uniform("player_position", this->position + Vector3(0, 0, this->player_height));
-    this->screen->set_uniform("facing_pitch", this->view_pitch);
-    this->screen->set_uniform("facing_yaw", this->view_yaw);
-    this->screen->set_uniform("FOV", (this->FOV * 3.1412f) / 180.0f);
+    this->view.position = this->position + Vector3(0, 0, this->player_height);
+    this->view.pitch = this->view_pitch;
+    this->view.yaw = this->view_yaw;
+    this->view.FOV = (this->FOV * 3.1412f) / 180.0f;
 }
 void Player::try_movement(Vector3 movement) {
     if (this->mode == Game_Mode::Cheat) {
         this->position += movement;
-        this->screen->set_uniform("player_position", this->position + Vector3(0, 0, this->player_height));
-        this->reset_cursor();
+        this->view.position = this->position + Vector3(0, 0, this->player_height);
+        this->cursor_dirty = true;
         return;
     }
 
@@ -45,17 +53,25 @@ void Player::try_movement(Vector3 movement) {
         movement.normalize();
     }
 
-    this->screen->set_uniform("player_position", this->position + Vector3(0, 0, this->player_height));
-    this->reset_cursor();
+    this->view.position = this->position + Vector3(0, 0, this->player_height);
+    this->cursor_dirty = true;
 }
-void Player::process_events(float deltatime) {
+void Player::process_events(const PlayerInput& input, float deltatime) {
+    this->tick = input.tick;
+    if (input.has_pick && (!this->has_pick || input.pick.frame != this->pick.frame)) {
+        this->pick = input.pick;
+        this->has_pick = true;
+        this->cursor_dirty = true;
+    }
+    if (input.mouse_motion_x != 0 || input.mouse_motion_y != 0) this->look(input.mouse_motion_x, input.mouse_motion_y);
+
     Vector3 forward = Vector3(cos(this->view_yaw), sin(this->view_yaw), 0);
     Vector3 right = Vector3(cos(this->view_yaw + 3.1412 / 2), sin(this->view_yaw + 3.1412 / 2), 0);
 
     Vector3 movement = Vector3(0, 0, 0);
     bool change_pos_needed = false;
 
-    const Uint8 *keystate = SDL_GetKeyboardState(NULL);
+    const Uint8 *keystate = input.keys;
     if (keystate[SDL_SCANCODE_W]) movement += forward;
     if (keystate[SDL_SCANCODE_S]) movement -= forward;
     if (keystate[SDL_SCANCODE_D]) movement += right;
@@ -82,11 +98,11 @@ void Player::process_events(float deltatime) {
 
     if (keystate[SDL_SCANCODE_KP_PLUS]) {
         this->FOV += 1;
-        this->screen->set_uniform("FOV", (this->FOV * 3.1412f) / 180.0f);
+        this->view.FOV = (this->FOV * 3.1412f) / 180.0f;
     }
     if (keystate[SDL_SCANCODE_KP_MINUS]) {
         this->FOV -= 1;
-        this->screen->set_uniform("FOV", (this->FOV * 3.1412f) / 180.0f);
+        this->view.FOV = (this->FOV * 3.1412f) / 180.0f;
     }
     
     if (movement.sqrmagnitude() != 0) {
@@ -95,49 +111,78 @@ void Player::process_events(float deltatime) {
         this->try_movement(movement * this->speed * deltatime);
     }
     else if (change_pos_needed)
-        this->screen->set_uniform("player_position", this->position + Vector3(0, 0, this->player_height));
+        this->view.position = this->position + Vector3(0, 0, this->player_height);
     
 
-    const Uint32 mousestate = SDL_GetMouseState(NULL, NULL);
+    const Uint32 mousestate = input.mouse_buttons;
     if (mousestate & SDL_BUTTON(SDL_BUTTON_LEFT)) break_block();
     if (mousestate & SDL_BUTTON(SDL_BUTTON_RIGHT)) place_block();
 }
 
 void Player::break_block() {
-    RaycastHit hit = world->raycast(this->position + Vector3(0, 0, this->player_height), this->get_direction(), 500);
+    RaycastHit hit = this->cursor_raycast();
     if (!hit.has_hit) return;
     world->set((hit.hit_point - hit.normal * 0.1).floor(), MATERIAL_AIR);
+    this->last_edit_tick = this->tick;
+    this->cursor_dirty = true;
 }
 void Player::place_block() {
-    RaycastHit hit = world->raycast(this->position + Vector3(0, 0, this->player_height), this->get_direction(), 500);
+    RaycastHit hit = this->cursor_raycast();
     if (!hit.has_hit) return;
     world->set((hit.hit_point + hit.normal * 0.1).floor(), this->placing);
+    this->last_edit_tick = this->tick;
+    this->cursor_dirty = true;
+}
+RaycastHit Player::get_pick_hit() {
+    RaycastHit hit;
+    hit.hit_point = Vector3(this->pick.hit_point[0], this->pick.hit_point[1], this->pick.hit_point[2]);
+    hit.normal = Vector3(this->pick.normal[0], this->pick.normal[1], this->pick.normal[2]);
+    hit.distance = this->pick.distance;
+    hit.cell_value = this->pick.value;
+    hit.has_hit = this->pick.has_hit != 0;
+    return hit;
+}
+bool Player::is_pick_current() {
+    // the snapshot of the edit tick may be drawn before its chunk is uploaded, only later frames count
+    if (!this->has_pick || this->pick.tick <= this->last_edit_tick) return false;
+    // the values the renderer was given, compared bit for bit
+    if (this->pick.origin[0] != this->view.position.x || this->pick.origin[1] != this->view.position.y || this->pick.origin[2] != this->view.position.z) return false;
+    return this->pick.pitch == this->view.pitch && this->pick.yaw == this->view.yaw;
+}
+RaycastHit Player::cursor_raycast() {
+    if (this->is_pick_current()) {
+        this->picks_used++;
+        return this->get_pick_hit();
+    }
+    this->cursor_raycasts++;
+    return world->raycast(this->position + Vector3(0, 0, this->player_height), this->get_direction(), 500);
 }
 void Player::reset_cursor() {
-    RaycastHit hit = world->raycast(this->position + Vector3(0, 0, this->player_height), this->get_direction(), 500);
+    this->cursor_dirty = false;
+    RaycastHit hit;
+    // the highlight follows the last pick even if the camera moved since (a few frames late), no raycast for it
+    if (this->has_pick) {
+        this->picks_used++;
+        hit = this->get_pick_hit();
+    }
+    else hit = this->cursor_raycast();
     
-    if (hit.has_hit) this->screen->set_uniform("player_target", hit.hit_point - hit.normal * 0.1);
-    else this->screen->set_uniform("player_target", Vector3(0, 0, 0));
+    if (hit.has_hit) this->view.target = hit.hit_point - hit.normal * 0.1;
+    else this->view.target = Vector3(0, 0, 0);
+}
+
+void Player::look(float x_move, float y_move) {
+    this->view_pitch = __max(-1.5708, __min(1.5708, this->view_pitch - y_move * this->FOV / 40000));
+    this->view_yaw += x_move * FOV / 40000;
+
+    this->view.pitch = this->view_pitch;
+    this->view.yaw = this->view_yaw;
+    this->cursor_dirty = true;
 }
 
 void Player::process_specific_event(SDL_Event event, float deltatime) {
     switch (event.type)
     {
-        case SDL_MOUSEMOTION:
-        {
-            float x_move = event.motion.xrel;
-            float y_move = event.motion.yrel;
-
-            this->view_pitch = __max(-1.5708, __min(1.5708, this->view_pitch - y_move * this->FOV / 40000));
-            this->view_yaw += x_move * FOV / 40000;
-
-            this->screen->set_uniform("facing_pitch", this->view_pitch);
-            this->screen->set_uniform("facing_yaw", this->view_yaw);
-
-            this->reset_cursor();
-        }
-        break;
-        
         case SDL_MOUSEBUTTONUP:
         {
             switch (event.button.button)
@@ -195,9 +240,13 @@ void Player::update(float deltatime) {
         else {
             this->position += this->velocity * deltatime;
             if (hit.has_hit) this->position.z = __max(this->position.z, hit.hit_point.z);
-            this->screen->set_uniform("player_position", this->position + Vector3(0, 0, this->player_height));
+            this->view.position = this->position + Vector3(0, 0, this->player_height);
+            this->cursor_dirty = true;
         }
     }
+
+    // every motion of the tick is applied, one raycast for all of them
+    if (this->cursor_dirty) this->reset_cursor();
 }
 
 #endif
\ No newline at end of file
@@ -1,6 +1,10 @@
 #ifndef _PLAYER_CLASS
 #define _PLAYER_CLASS
 
+#include <vector>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
 #include "../utility/math/vector3.h"
 #include "../utility/graphics/screen.h"
 #include "../world/world.h"
@@ -10,6 +14,32 @@
 
 enum Game_Mode { Normal, Cheat };
 
+// what the renderer needs of the player, copied into each snapshot of the simulation
+struct PlayerView
+{
+    Vector3 position = Vector3(0, 0, 0);    // camera position
+    float pitch = 0, yaw = 0;
+    float FOV = 0;                          // radians
+    Vector3 target = Vector3(0, 0, 0);      // voxel under the cursor, (0, 0, 0) for none
+};
+// keyboard, mouse and events of a tick, gathered by the thread polling SDL
+struct PlayerInput
+{
+    Uint8 keys[SDL_NUM_SCANCODES] = {};
+    Uint32 mouse_buttons = 0;
+    // sum of the relative motion of the SDL_MOUSEMOTION events, applied once per tick
+    float mouse_motion_x = 0, mouse_motion_y = 0;
+    // every other event
+    std::vector<SDL_Event> events;
+    // events received, motion included
+    unsigned int event_count = 0;
+    // the last crosshair ray read back from the gpu
+    PickResult pick;
+    bool has_pick = false;
+    // tick this input is for
+    unsigned int tick = 0;
+};
+
 class Player
 {
 private:
@@ -22,26 +52,47 @@ private:
     int FOV = 60;
     float speed = BASE_PLAYER_SPEED;
     float player_height = BASE_PLAYER_HEIGHT;
-    Screen* screen;
+    PlayerView view;
     World* world;
+    // the target is raycast once per tick, when the camera or the world changed
+    bool cursor_dirty = true;
+    unsigned int cursor_raycasts = 0;
+    // the gpu pick answers the crosshair raycast while the camera has not moved since its frame
+    // and the world was not edited after the tick of its frame
+    PickResult pick;
+    bool has_pick = false;
+    unsigned int tick = 0;
+    unsigned int last_edit_tick = 0;
+    unsigned int picks_used = 0;
 
     void break_block();
     void place_block();
     void reset_cursor();
+    RaycastHit get_pick_hit();
+    // the camera did not move since the frame of the pick and the world was not edited after it
+    bool is_pick_current();
+    // the hit under the crosshair, from the gpu pick when it is current
+    RaycastHit cursor_raycast();
+    void look(float x_move, float y_move);
     
     void try_movement(Vector3 movement);
 public:
     Vector3 position = Vector3(0, 0, 0);
 
-    Player(Vector3 position, Screen* screen, World* world);
+    Player(Vector3 position, World* world);
     void dispose();
 
     void send_data();
-    void process_events(float deltatime);
+    void process_events(const PlayerInput& input, float deltatime);
     void process_specific_event(SDL_Event event, float deltatime);
     void update(float deltatime);
 
     Vector3 get_direction();
+    const PlayerView& get_view();
+    // cpu raycasts done for the crosshair since the creation
+    unsigned int get_cursor_raycasts();
+    // crosshair raycasts answered by the gpu pick since the creation
+    unsigned int get_picks_used();
 };
 
 
@@ -0,0 +1,176 @@
+#ifndef _SIMULATION_CLASS
+
+#include "./simulation.h"
+
+Simulation::Simulation(Player* player, World* world, EntityStore* entities) {
+    this->player = player;
+    this->world = world;
+    this->entities = entities;
+
+    for (FrameSnapshot& snapshot : this->snapshots)
+    {
+        snapshot.player = this->player->get_view();
+        snapshot.previous_position = snapshot.player.position;
+        snapshot.time = std::chrono::steady_clock::now();
+    }
+}
+
+void Simulation::start() {
+    #ifndef DISABLE_THREAD
+    if (this->running) return;
+    this->running = true;
+    this->thread = mingw_stdthread::thread(&Simulation::run, this);
+    #endif
+}
+void Simulation::stop() {
+    #ifndef DISABLE_THREAD
+    if (!this->running) return;
+    this->running = false;
+    this->thread.join();
+    #endif
+}
+
+#ifndef DISABLE_THREAD
+void Simulation::run() {
+    const float step = 1.0f / SIMULATION_TICK_RATE;
+
+    auto last = std::chrono::steady_clock::now();
+    while (this->running)
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<float> elapsed = now - last;
+        last = now;
+        this->advance(elapsed.count());
+
+        // wake up when the next tick is due
+        mingw_stdthread::this_thread::sleep_for(std::chrono::duration<float>(step - this->lag));
+    }
+}
+#endif
+void Simulation::update(float deltatime) {
+    #ifdef DISABLE_THREAD
+    this->advance(deltatime);
+    #endif
+}
+unsigned int Simulation::advance(float seconds) {
+    const float step = 1.0f / SIMULATION_TICK_RATE;
+    auto now = std::chrono::steady_clock::now();
+    this->lag += seconds;
+
+    unsigned int ticks = 0;
+    while (this->lag >= step && ticks < SIMULATION_MAX_CATCH_UP)
+    {
+        this->lag -= step;
+        this->tick(now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(this->lag)));
+        ticks++;
+    }
+    if (this->lag >= step) this->lag = 0;
+    return ticks;
+}
+
+void Simulation::tick(std::chrono::steady_clock::time_point time) {
+    auto start = std::chrono::steady_clock::now();
+    const float deltatime = 1.0f / SIMULATION_TICK_RATE;
+    Vector3 previous_position = this->player->get_view().position;
+
+    PlayerInput tick_input;
+    {
+        #ifndef DISABLE_THREAD
+        std::lock_guard<mingw_stdthread::mutex> guard(this->input_lock);
+        #endif
+        memcpy(tick_input.keys, this->input.keys, sizeof(tick_input.keys));
+        tick_input.mouse_buttons = this->input.mouse_buttons;
+        tick_input.mouse_motion_x = this->input.mouse_motion_x;
+        tick_input.mouse_motion_y = this->input.mouse_motion_y;
+        tick_input.event_count = this->input.event_count;
+        tick_input.pick = this->input.pick;
+        tick_input.has_pick = this->input.has_pick;
+        tick_input.events.swap(this->input.events);
+
+        this->input.mouse_motion_x = 0;
+        this->input.mouse_motion_y = 0;
+        this->input.event_count = 0;
+    }
+    this->event_count += tick_input.event_count;
+    tick_input.tick = this->tick_count + 1;
+
+    for (SDL_Event& event : tick_input.events)
+        this->player->process_specific_event(event, deltatime);
+
+    this->world->update(0);
+    this->player->process_events(tick_input, deltatime);
+    this->player->update(deltatime);
+    if (this->entities != nullptr) this->entities->update(deltatime);
+    this->tick_count++;
+
+    // only this thread writes the snapshots, the published one is left alone until the swap
+    FrameSnapshot& next = this->snapshots[1 - this->published];
+    next.player = this->player->get_view();
+    next.previous_position = previous_position;
+    next.tick = this->tick_count;
+    next.time = time;
+    next.events = this->event_count;
+    next.cursor_raycasts = this->player->get_cursor_raycasts();
+    next.picks_used = this->player->get_picks_used();
+    next.entities = (this->entities != nullptr) ? this->entities->get_count() : 0;
+    {
+        #ifndef DISABLE_THREAD
+        std::lock_guard<mingw_stdthread::mutex> guard(this->snapshot_lock);
+        #endif
+        this->published = 1 - this->published;
+        std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+        this->tick_time = elapsed.count();
+    }
+}
+
+void Simulation::push_event(SDL_Event event) {
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->input_lock);
+    #endif
+    this->input.event_count++;
+    if (event.type == SDL_MOUSEMOTION) {
+        this->input.mouse_motion_x += event.motion.xrel;
+        this->input.mouse_motion_y += event.motion.yrel;
+        return;
+    }
+    this->input.events.push_back(event);
+}
+void Simulation::set_input_state(const Uint8* keys, Uint32 mouse_buttons) {
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->input_lock);
+    #endif
+    memcpy(this->input.keys, keys, sizeof(this->input.keys));
+    this->input.mouse_buttons = mouse_buttons;
+}
+void Simulation::set_pick(const PickResult& pick) {
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->input_lock);
+    #endif
+    this->input.pick = pick;
+    this->input.has_pick = true;
+}
+FrameSnapshot Simulation::get_snapshot() {
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->snapshot_lock);
+    #endif
+    return this->snapshots[this->published];
+}
+PlayerView Simulation::get_view(const FrameSnapshot& snapshot) {
+    std::chrono::duration<float> since = std::chrono::steady_clock::now() - snapshot.time;
+    float alpha = __max(0.0f, __min(1.0f, since.count() * SIMULATION_TICK_RATE));
+
+    PlayerView view = snapshot.player;
+    Vector3 previous = snapshot.previous_position;
+    // exact when the camera did not move, the gpu pick compares it bit for bit
+    if (previous != view.position)
+        view.position = previous + (view.position - previous) * alpha;
+    return view;
+}
+float Simulation::get_tick_time() {
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->snapshot_lock);
+    #endif
+    return this->tick_time;
+}
+
+#endif
\ No newline at end of file
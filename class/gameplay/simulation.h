@@ -0,0 +1,93 @@
+#ifndef _SIMULATION_CLASS
+#define _SIMULATION_CLASS
+
+#include <iostream>
+#include <chrono>
+#ifndef DISABLE_THREAD
+#include "../../mingw_stdthreads/mingw.thread.h"
+#include "../../mingw_stdthreads/mingw.mutex.h"
+#endif
+#include <atomic>
+
+#include "./player.h"
+#include "./entity_store.h"
+#include "../world/world.h"
+
+// ticks per second, the player and the world always advance by 1 / SIMULATION_TICK_RATE seconds
+#define SIMULATION_TICK_RATE 60
+// ticks run back to back to catch up after a hitch, the time late beyond that is dropped
+#define SIMULATION_MAX_CATCH_UP 5
+
+// state after a tick, not modified once published
+struct FrameSnapshot
+{
+    PlayerView player;
+    // camera position of the tick before, the renderer draws between the two
+    Vector3 previous_position = Vector3(0, 0, 0);
+    unsigned int tick = 0;
+    // when the state of this tick is the current one, the next tick is one step later
+    std::chrono::steady_clock::time_point time;
+    // totals since the start, the difference between two snapshots gives the rate
+    unsigned int events = 0;
+    unsigned int cursor_raycasts = 0;
+    unsigned int picks_used = 0;
+    unsigned int entities = 0;
+};
+
+// world and player updated at a fixed tick on their own thread (the caller thread with DISABLE_THREAD)
+// the render thread owns the gl context: it gives the input, reads the last snapshot
+// and copies the chunks changed by the ticks with World::upload_pending
+class Simulation
+{
+private:
+    Player* player;
+    World* world;
+    // optional, its systems run after the player
+    EntityStore* entities;
+
+    // written by the render thread, consumed by the next tick
+    PlayerInput input;
+    // the tick writes the one not published, then swaps
+    FrameSnapshot snapshots[2];
+    unsigned int published = 0;
+    unsigned int tick_count = 0;
+    unsigned int event_count = 0;
+    float tick_time = 0;
+    // seconds of real time not simulated yet
+    float lag = 0;
+
+    #ifndef DISABLE_THREAD
+    mingw_stdthread::thread thread;
+    mingw_stdthread::mutex input_lock;
+    mingw_stdthread::mutex snapshot_lock;
+    std::atomic_bool running = {false};
+
+    void run();
+    #endif
+    // runs the ticks due after seconds more of real time (accumulator), drops the time it can't catch up
+    unsigned int advance(float seconds);
+    void tick(std::chrono::steady_clock::time_point time);
+public:
+    Simulation(Player* player, World* world, EntityStore* entities = nullptr);
+    Simulation & operator=(const Simulation&) = delete;
+    Simulation(const Simulation&) = delete;
+
+    void start();
+    void stop();
+
+    // render thread side, mouse motions are summed until the next tick
+    void push_event(SDL_Event event);
+    void set_input_state(const Uint8* keys, Uint32 mouse_buttons);
+    // the last pick read back by the screen
+    void set_pick(const PickResult& pick);
+    // runs the ticks due after deltatime seconds, only without thread
+    void update(float deltatime);
+    FrameSnapshot get_snapshot();
+    // the camera to draw now: the position is interpolated between the last two ticks
+    PlayerView get_view(const FrameSnapshot& snapshot);
+
+    // seconds taken by the last tick
+    float get_tick_time();
+};
+
+#endif
\ No newline at end of file
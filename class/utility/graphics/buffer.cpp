@@ -4,110 +4,142 @@
 #include "./buffer.h"
 #include "buffer.h"
 
-Buffer::Buffer(bool initialize)
+Buffer::Buffer(bool initialize, BufferDevice* device)
 {
+    this->device = (device != nullptr) ? device : BufferDevice::get_default();
     if (!initialize) return;
     this->initialized = true;
 
-    glGenBuffers(1, &this->buffer_id);
-
-    glNamedBufferData(this->buffer_id, 0, NULL, GL_DYNAMIC_DRAW);
+    this->buffer_id = this->device->create_buffer();
+    this->device->buffer_data(this->buffer_id, 0, NULL);
 }
 void Buffer::dispose() {
-    glDeleteBuffers(1, &this->buffer_id);
+    this->device->delete_buffer(this->buffer_id);
 }
 bool Buffer::is_buffer() {
     if (!this->initialized) return false;
-    return glIsBuffer(this->buffer_id);
+    return this->device->is_buffer(this->buffer_id);
 }
 
 void Buffer::set_data(GLsizeiptr size, const void *data) {
     this->buffer_size = size;
-    glNamedBufferData(this->buffer_id, size, data, GL_DYNAMIC_DRAW);
+    this->device->buffer_data(this->buffer_id, size, data);
 }
 void Buffer::set_data(GLsizeiptr offset, GLsizeiptr size, const void *data) {
-    glNamedBufferSubData(this->buffer_id, offset, size, data);
+    this->device->buffer_sub_data(this->buffer_id, offset, size, data);
 }
 
 void Buffer::bind_buffer(GLuint index) {
     this->binding = index;
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, this->buffer_id);
+    this->bound = true;
+    this->device->bind_storage(index, this->buffer_id);
 }
 unsigned int Buffer::get_used_size() {
     return this->buffer_size;
 }
+GLuint Buffer::get_id() {
+    return this->buffer_id;
+}
 
 
-GrowableBuffer::GrowableBuffer(bool initialize, unsigned int added_storage, unsigned int start_size): Buffer(initialize)
+GrowableBuffer::GrowableBuffer(bool initialize, unsigned int added_storage, unsigned int start_size, BufferDevice* device): Buffer(initialize, device)
 {
     if (!initialize) return;
     this->buffer_added_storage = added_storage;
     this->used_storage = 0;
 
     this->buffer_size = start_size;
-    glNamedBufferData(this->buffer_id, this->buffer_size, NULL, GL_DYNAMIC_DRAW);
+    this->device->buffer_data(this->buffer_id, this->buffer_size, NULL);
 
 }
-void GrowableBuffer::set_data(GLsizeiptr size, const void *data) {
-    if (size > this->buffer_size + this->buffer_added_storage) {
-        std::cerr << "too big !!";
-        exit(-1);
-    }
-    if (size < this->buffer_size && size > this->buffer_size - 2*this->buffer_added_storage) { // do not realocate if the size is small enough
-        return this->set_data(0, size, data);
-    }
-
-    this->used_storage = size;
-    this->buffer_size = size + this->buffer_added_storage;
-    glNamedBufferData(this->buffer_id, this->buffer_size, NULL, GL_DYNAMIC_DRAW);
+void GrowableBuffer::dispose() {
+    if (this->scratch_id != 0) this->device->delete_buffer(this->scratch_id);
+    this->scratch_id = 0;
+    this->scratch_size = 0;
+    Buffer::dispose();
+}
 
-    glNamedBufferSubData(this->buffer_id, 0, size, data);
+void GrowableBuffer::reallocate(GLsizeiptr required, GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size) {
+    GLsizeiptr capacity = __max(required + (GLsizeiptr)this->buffer_added_storage, (GLsizeiptr)(this->buffer_size * GROWABLE_BUFFER_GROWTH));
+    GLsizeiptr tail = this->used_storage - offset - old_size;
+
+    // copy straight into the new buffer, the head stays in place and the tail moves to its new offset
+    GLuint new_id = this->device->create_buffer();
+    this->device->buffer_data(new_id, capacity, NULL);
+    if (offset > 0) this->device->copy_buffer(this->buffer_id, new_id, 0, 0, offset);
+    if (tail > 0) this->device->copy_buffer(this->buffer_id, new_id, offset + old_size, offset + new_size, tail);
+    this->device->delete_buffer(this->buffer_id);
+
+    this->buffer_id = new_id;
+    this->buffer_size = capacity;
+    // the shaders still see the old buffer until it is bound again
+    if (this->bound) this->device->bind_storage(this->binding, this->buffer_id);
 }
-void GrowableBuffer::set_data(GLsizeiptr offset, GLsizeiptr size, const void *data) {
-    if (offset + size > this->buffer_size + this->buffer_added_storage) {
-        std::cerr << "too big !!";
-        exit(-1);
+void GrowableBuffer::make_room(GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size) {
+    GLsizeiptr used = this->used_storage;
+    offset = __min(offset, used);
+    old_size = __min(old_size, used - offset);
+    GLsizeiptr tail = used - offset - old_size;
+    GLsizeiptr required = offset + new_size + tail;
+
+    if (required > this->buffer_size) {
+        this->reallocate(required, offset, old_size, new_size);
     }
-    if (offset + size <= this->buffer_size) {
-        this->used_storage = __max(this->used_storage, offset + size);
-        glNamedBufferSubData(this->buffer_id, offset, size, data);
-        return;
+    else if (new_size != old_size && tail > 0) {
+        GLintptr source = offset + old_size;
+        GLintptr destination = offset + new_size;
+        GLsizeiptr distance = (source > destination) ? source - destination : destination - source;
+
+        if (distance >= tail) {
+            this->device->copy_buffer(this->buffer_id, this->buffer_id, source, destination, tail);
+        }
+        else {
+            // overlapping ranges of the same buffer can't be copied directly, go through the scratch buffer
+            if (this->scratch_size < tail) {
+                if (this->scratch_id != 0) this->device->delete_buffer(this->scratch_id);
+                this->scratch_size = __max(tail, (GLsizeiptr)(this->scratch_size * GROWABLE_BUFFER_GROWTH));
+                this->scratch_id = this->device->create_buffer();
+                this->device->buffer_data(this->scratch_id, this->scratch_size, NULL);
+            }
+            this->device->copy_buffer(this->buffer_id, this->scratch_id, source, 0, tail);
+            this->device->copy_buffer(this->scratch_id, this->buffer_id, 0, destination, tail);
+        }
     }
-    if (offset == 0 && size > this->buffer_size) {
-        this->set_data(size, data);
-        return;
-    }
-    
-    const void* old_data = glMapNamedBufferRange(this->buffer_id, 0, offset, GL_MAP_READ_BIT);
-    glUnmapNamedBuffer(this->buffer_id);
-
-    glNamedBufferData(this->buffer_id, offset + size + this->buffer_added_storage, NULL, GL_DYNAMIC_DRAW); // reinitialize the buffer to the right size
-    glNamedBufferSubData(this->buffer_id, 0, offset, old_data);
-    glNamedBufferSubData(this->buffer_id, offset, size, data);
 
-    this->buffer_size = offset + size + this->buffer_added_storage;
-    this->used_storage = offset + size;
+    this->used_storage = required;
 }
-void GrowableBuffer::replace_data(GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size, const void *data) {
-    if (new_size == old_size) {
-        glNamedBufferSubData(this->buffer_id, offset, new_size, data);
-        return;
-    }
 
-    const void* old_data_start = glMapNamedBufferRange(this->buffer_id, 0, offset, GL_MAP_READ_BIT);
-    glUnmapNamedBuffer(this->buffer_id);
+void GrowableBuffer::set_data(GLsizeiptr size, const void *data) {
+    // the old content is dropped, no need to keep it when growing
+    if (size > this->buffer_size) {
+        this->buffer_size = __max(size + (GLsizeiptr)this->buffer_added_storage, (GLsizeiptr)(this->buffer_size * GROWABLE_BUFFER_GROWTH));
+        this->device->buffer_data(this->buffer_id, this->buffer_size, NULL);
+    }
 
-    unsigned int end_size = this->used_storage - offset - old_size;
-    const void* old_data_end = glMapNamedBufferRange(this->buffer_id, offset + old_size, end_size, GL_MAP_READ_BIT);
-    glUnmapNamedBuffer(this->buffer_id);
+    this->used_storage = size;
+    this->device->buffer_sub_data(this->buffer_id, 0, size, data);
+}
+void GrowableBuffer::set_data(GLsizeiptr offset, GLsizeiptr size, const void *data) {
+    if (offset + size > this->buffer_size) this->reallocate(offset + size, this->used_storage, 0, 0);
 
-    glNamedBufferData(this->buffer_id, offset + new_size + end_size + this->buffer_added_storage, NULL, GL_DYNAMIC_DRAW); // reinitialize the buffer to the right size
-    glNamedBufferSubData(this->buffer_id, 0, offset, old_data_start);                   // before new data
-    glNamedBufferSubData(this->buffer_id, offset, new_size, data);                      // new data
-    glNamedBufferSubData(this->buffer_id, offset + new_size, end_size, old_data_end);   // after new data
+    this->used_storage = __max((GLsizeiptr)this->used_storage, offset + size);
+    this->device->buffer_sub_data(this->buffer_id, offset, size, data);
+}
+void GrowableBuffer::replace_data(GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size, const void *data) {
+    this->make_room(offset, old_size, new_size);
+    if (new_size > 0 && data != NULL) this->device->buffer_sub_data(this->buffer_id, offset, new_size, data);
+}
+void GrowableBuffer::replace_data(GLsizeiptr offset, GLsizeiptr old_size, UploadRing& ring, UploadRegion& region) {
+    this->make_room(offset, old_size, region.size);
+    ring.copy_to(this->buffer_id, offset, region);
+}
+bool GrowableBuffer::copy_data(GLsizeiptr offset, UploadRing& ring, UploadRegion& region) {
+    if (!region.is_valid()) return false;
+    if (offset + region.size > this->buffer_size) this->reallocate(offset + region.size, this->used_storage, 0, 0);
 
-    this->buffer_size = offset + new_size + end_size + this->buffer_added_storage;
-    this->used_storage = offset + new_size + end_size;
+    this->used_storage = __max((GLsizeiptr)this->used_storage, offset + region.size);
+    ring.copy_to(this->buffer_id, offset, region);
+    return true;
 }
 unsigned int GrowableBuffer::push_data(GLsizeiptr size, const void *data) {
     unsigned int index_added = this->used_storage;
@@ -8,16 +8,25 @@
 #include <GL/glew.h>
 #include <SDL_opengl.h>
 
+#include "./buffer_device.h"
+#include "./upload_ring.h"
+
+// a GrowableBuffer at least doubles its storage when it has to grow
+#define GROWABLE_BUFFER_GROWTH 2
+
 class Buffer
 {
 private:
 protected:
     bool initialized = false;
+    BufferDevice* device = nullptr;
     GLuint buffer_id = 0;
     unsigned int buffer_size = 0;
     GLuint binding = 0;
+    bool bound = false;
 public:
-    Buffer(bool initialize = false);
+    // without a device the buffer uses OpenGL (BufferDevice::get_default)
+    Buffer(bool initialize = false, BufferDevice* device = nullptr);
     void dispose();
     bool is_buffer();
 
@@ -27,6 +36,7 @@ public:
     void bind_buffer(GLuint index);
 
     unsigned int get_used_size();
+    GLuint get_id();
 };
 
 class GrowableBuffer: public Buffer
@@ -34,13 +44,27 @@ class GrowableBuffer: public Buffer
 private:
     unsigned int buffer_added_storage = 0;
     unsigned int used_storage = 0;
+    // gpu side copy of the overlapping ranges when shifting in place
+    GLuint scratch_id = 0;
+    GLsizeiptr scratch_size = 0;
+
+    // move to a bigger buffer object (geometric growth), resizing [offset, offset + old_size) to new_size on the way
+    void reallocate(GLsizeiptr required, GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size);
+    // resize [offset, offset + old_size) to new_size, moving what comes after it, without going through the cpu
+    void make_room(GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size);
 public:
-    GrowableBuffer(bool initialize = false, unsigned int added_storage = sizeof(unsigned int), unsigned int start_size = 0);
+    GrowableBuffer(bool initialize = false, unsigned int added_storage = sizeof(unsigned int), unsigned int start_size = 0, BufferDevice* device = nullptr);
+    void dispose();
 
     void set_data(GLsizeiptr size, const void *data);
     void set_data(GLsizeiptr offset, GLsizeiptr size, const void *data);
     unsigned int push_data(GLsizeiptr size, const void *data);
+    // data can be NULL to only resize the range
     void replace_data(GLsizeiptr offset, GLsizeiptr old_size, GLsizeiptr new_size, const void *data);
+    // same with the new data coming from the upload ring
+    void replace_data(GLsizeiptr offset, GLsizeiptr old_size, UploadRing& ring, UploadRegion& region);
+    // gpu side copy of a region of the upload ring, returns false if the region is invalid
+    bool copy_data(GLsizeiptr offset, UploadRing& ring, UploadRegion& region);
     
     unsigned int get_used_size();
 };
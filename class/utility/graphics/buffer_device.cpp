@@ -0,0 +1,193 @@
+#ifndef _BUFFER_DEVICE_CLASS
+
+#include "./buffer_device.h"
+#include "./openGL_related.h"
+
+BufferDevice* BufferDevice::get_default() {
+    static GLBufferDevice device;
+    return &device;
+}
+
+#pragma region GLBufferDevice
+GLuint GLBufferDevice::create_buffer() {
+    // created (not only named) so the named buffer functions work on strict drivers like mesa
+    GLuint buffer;
+    count_gl_calls();
+    glCreateBuffers(1, &buffer);
+    return buffer;
+}
+void GLBufferDevice::delete_buffer(GLuint buffer) {
+    count_gl_calls();
+    glDeleteBuffers(1, &buffer);
+}
+bool GLBufferDevice::is_buffer(GLuint buffer) {
+    count_gl_calls();
+    return glIsBuffer(buffer);
+}
+
+void GLBufferDevice::buffer_data(GLuint buffer, GLsizeiptr size, const void* data) {
+    count_gl_calls();
+    glNamedBufferData(buffer, size, data, GL_DYNAMIC_DRAW);
+}
+void GLBufferDevice::buffer_sub_data(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) {
+    count_gl_calls();
+    glNamedBufferSubData(buffer, offset, size, data);
+}
+void GLBufferDevice::copy_buffer(GLuint source, GLuint destination, GLintptr source_offset, GLintptr destination_offset, GLsizeiptr size) {
+    count_gl_calls();
+    glCopyNamedBufferSubData(source, destination, source_offset, destination_offset, size);
+}
+void GLBufferDevice::bind_storage(GLuint binding, GLuint buffer) {
+    count_gl_calls();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, buffer);
+}
+
+void* GLBufferDevice::create_mapped_storage(GLuint buffer, GLsizeiptr size) {
+    if (!GLEW_VERSION_4_4 && !GLEW_ARB_buffer_storage) return nullptr;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    count_gl_calls(2);
+    glNamedBufferStorage(buffer, size, NULL, flags);
+    return glMapNamedBufferRange(buffer, 0, size, flags);
+}
+void GLBufferDevice::unmap(GLuint buffer) {
+    count_gl_calls();
+    glUnmapNamedBuffer(buffer);
+}
+
+GLsync GLBufferDevice::insert_fence() {
+    count_gl_calls();
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+void GLBufferDevice::wait_fence(GLsync fence) {
+    count_gl_calls();
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        count_gl_calls();
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+}
+void GLBufferDevice::delete_fence(GLsync fence) {
+    count_gl_calls();
+    glDeleteSync(fence);
+}
+void GLBufferDevice::finish() {
+    count_gl_calls();
+    glFinish();
+}
+#pragma endregion
+
+#pragma region MockBufferDevice
+void MockBufferDevice::record(DeviceCallType type, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    this->stats.calls++;
+    if (this->record_calls) this->calls.push_back({ type, buffer, offset, size });
+}
+bool MockBufferDevice::check(bool condition, const char* message) {
+    if (condition) return true;
+    std::cerr << "MockBufferDevice: " << message << "\n";
+    this->errors++;
+    return false;
+}
+
+GLuint MockBufferDevice::create_buffer() {
+    GLuint buffer = this->next_buffer++;
+    this->buffers[buffer] = std::vector<char>();
+    this->immutable[buffer] = false;
+    this->record(DeviceCallType::Create, buffer);
+    return buffer;
+}
+void MockBufferDevice::delete_buffer(GLuint buffer) {
+    this->record(DeviceCallType::Delete, buffer);
+    this->buffers.erase(buffer);
+    this->immutable.erase(buffer);
+    // like glDeleteBuffers, deleting a bound buffer unbinds it
+    for (auto& binding : this->bindings)
+        if (binding.second == buffer) binding.second = 0;
+}
+bool MockBufferDevice::is_buffer(GLuint buffer) {
+    return this->buffers.count(buffer) != 0;
+}
+
+void MockBufferDevice::buffer_data(GLuint buffer, GLsizeiptr size, const void* data) {
+    this->record(DeviceCallType::Data, buffer, 0, size);
+    if (!this->check(this->is_buffer(buffer), "buffer_data on an unknown buffer")) return;
+    if (!this->check(!this->immutable[buffer], "buffer_data on immutable storage")) return;
+
+    std::vector<char>& content = this->buffers[buffer];
+    content.assign(size, 0);
+    if (data != NULL && size > 0) {
+        memcpy(&content[0], data, size);
+        this->stats.uploads++;
+        this->stats.bytes_uploaded += size;
+    }
+    this->stats.bytes_allocated += size;
+}
+void MockBufferDevice::buffer_sub_data(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) {
+    this->record(DeviceCallType::SubData, buffer, offset, size);
+    if (!this->check(this->is_buffer(buffer), "buffer_sub_data on an unknown buffer")) return;
+    if (!this->check(offset >= 0 && offset + size <= (GLsizeiptr)this->buffers[buffer].size(), "buffer_sub_data out of range")) return;
+
+    if (size > 0 && data != NULL) memcpy(&this->buffers[buffer][offset], data, size);
+    this->stats.uploads++;
+    this->stats.bytes_uploaded += size;
+}
+void MockBufferDevice::copy_buffer(GLuint source, GLuint destination, GLintptr source_offset, GLintptr destination_offset, GLsizeiptr size) {
+    this->record(DeviceCallType::Copy, destination, destination_offset, size);
+    if (!this->check(this->is_buffer(source) && this->is_buffer(destination), "copy_buffer with an unknown buffer")) return;
+    if (!this->check(source_offset + size <= (GLsizeiptr)this->buffers[source].size(), "copy_buffer source out of range")) return;
+    if (!this->check(destination_offset + size <= (GLsizeiptr)this->buffers[destination].size(), "copy_buffer destination out of range")) return;
+    if (source == destination) {
+        GLintptr distance = (source_offset > destination_offset) ? source_offset - destination_offset : destination_offset - source_offset;
+        if (!this->check(distance >= size, "copy_buffer with overlapping ranges")) return;
+    }
+
+    if (size > 0) memmove(&this->buffers[destination][destination_offset], &this->buffers[source][source_offset], size);
+    this->stats.copies++;
+    this->stats.bytes_copied += size;
+}
+void MockBufferDevice::bind_storage(GLuint binding, GLuint buffer) {
+    this->record(DeviceCallType::Bind, buffer, binding);
+    this->bindings[binding] = buffer;
+}
+
+void* MockBufferDevice::create_mapped_storage(GLuint buffer, GLsizeiptr size) {
+    this->record(DeviceCallType::Map, buffer, 0, size);
+    if (!this->check(this->is_buffer(buffer), "create_mapped_storage on an unknown buffer")) return nullptr;
+
+    // immutable: the vector is never resized again so the pointer stays valid
+    this->buffers[buffer].assign(size, 0);
+    this->immutable[buffer] = true;
+    this->stats.bytes_allocated += size;
+    return &this->buffers[buffer][0];
+}
+void MockBufferDevice::unmap(GLuint buffer) {}
+
+GLsync MockBufferDevice::insert_fence() {
+    this->record(DeviceCallType::Fence);
+    return (GLsync)(this->next_fence++);
+}
+void MockBufferDevice::wait_fence(GLsync fence) {
+    // commands run right away, there is never anything to wait for
+    this->record(DeviceCallType::Wait);
+}
+void MockBufferDevice::delete_fence(GLsync fence) {}
+void MockBufferDevice::finish() {}
+
+void MockBufferDevice::reset_stats() {
+    this->calls.clear();
+    this->stats = DeviceStats();
+}
+std::vector<char>* MockBufferDevice::get_data(GLuint buffer) {
+    if (!this->is_buffer(buffer)) return nullptr;
+    return &this->buffers[buffer];
+}
+GLuint MockBufferDevice::get_binding(GLuint binding) {
+    if (this->bindings.count(binding) == 0) return 0;
+    return this->bindings[binding];
+}
+unsigned int MockBufferDevice::get_buffer_count() {
+    return this->buffers.size();
+}
+#pragma endregion
+
+#endif
\ No newline at end of file
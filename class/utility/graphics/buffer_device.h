@@ -0,0 +1,138 @@
+#ifndef _BUFFER_DEVICE_CLASS
+#define _BUFFER_DEVICE_CLASS
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <cstdint>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <GL/glew.h>
+#include <SDL_opengl.h>
+
+// every buffer operation Buffer, GrowableBuffer and UploadRing need
+// GLBufferDevice runs them with OpenGL, MockBufferDevice in memory without any context
+class BufferDevice
+{
+public:
+    virtual ~BufferDevice() {}
+
+    virtual GLuint create_buffer() = 0;
+    virtual void delete_buffer(GLuint buffer) = 0;
+    virtual bool is_buffer(GLuint buffer) = 0;
+
+    // (re)allocate the storage, data can be NULL
+    virtual void buffer_data(GLuint buffer, GLsizeiptr size, const void* data) = 0;
+    virtual void buffer_sub_data(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) = 0;
+    virtual void copy_buffer(GLuint source, GLuint destination, GLintptr source_offset, GLintptr destination_offset, GLsizeiptr size) = 0;
+    // bind to a shader storage binding point
+    virtual void bind_storage(GLuint binding, GLuint buffer) = 0;
+
+    // immutable storage mapped for writing as long as the buffer lives (persistent and coherent), nullptr if not supported
+    virtual void* create_mapped_storage(GLuint buffer, GLsizeiptr size) = 0;
+    virtual void unmap(GLuint buffer) = 0;
+
+    virtual GLsync insert_fence() = 0;
+    // block until the commands before the fence are done
+    virtual void wait_fence(GLsync fence) = 0;
+    virtual void delete_fence(GLsync fence) = 0;
+    // block until every command is done
+    virtual void finish() = 0;
+
+    // the OpenGL device, used when no device is given
+    static BufferDevice* get_default();
+};
+
+class GLBufferDevice: public BufferDevice
+{
+public:
+    GLuint create_buffer();
+    void delete_buffer(GLuint buffer);
+    bool is_buffer(GLuint buffer);
+
+    void buffer_data(GLuint buffer, GLsizeiptr size, const void* data);
+    void buffer_sub_data(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+    void copy_buffer(GLuint source, GLuint destination, GLintptr source_offset, GLintptr destination_offset, GLsizeiptr size);
+    void bind_storage(GLuint binding, GLuint buffer);
+
+    void* create_mapped_storage(GLuint buffer, GLsizeiptr size);
+    void unmap(GLuint buffer);
+
+    GLsync insert_fence();
+    void wait_fence(GLsync fence);
+    void delete_fence(GLsync fence);
+    void finish();
+};
+
+enum class DeviceCallType { Create, Delete, Data, SubData, Copy, Bind, Map, Fence, Wait };
+
+// one call made to a MockBufferDevice
+struct DeviceCall
+{
+    DeviceCallType type;
+    GLuint buffer = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+};
+
+struct DeviceStats
+{
+    unsigned int calls = 0;
+    unsigned int uploads = 0;
+    unsigned int copies = 0;
+    // bytes sent from the cpu (buffer_data with data, buffer_sub_data)
+    unsigned long long bytes_uploaded = 0;
+    // bytes moved from buffer to buffer
+    unsigned long long bytes_copied = 0;
+    // bytes of storage (re)allocated
+    unsigned long long bytes_allocated = 0;
+};
+
+// keeps the buffers in cpu memory and records every call, for headless tests and benchmarks
+// the GL rules the engine relies on are checked (unknown buffers, out of range, overlapping copies)
+class MockBufferDevice: public BufferDevice
+{
+private:
+    std::map<GLuint, std::vector<char>> buffers;
+    std::map<GLuint, bool> immutable;
+    std::map<GLuint, GLuint> bindings;
+    GLuint next_buffer = 1;
+    uintptr_t next_fence = 1;
+
+    void record(DeviceCallType type, GLuint buffer = 0, GLintptr offset = 0, GLsizeiptr size = 0);
+    // prints the error and counts it
+    bool check(bool condition, const char* message);
+public:
+    bool record_calls = true;
+    std::vector<DeviceCall> calls;
+    DeviceStats stats;
+    unsigned int errors = 0;
+
+    GLuint create_buffer();
+    void delete_buffer(GLuint buffer);
+    bool is_buffer(GLuint buffer);
+
+    void buffer_data(GLuint buffer, GLsizeiptr size, const void* data);
+    void buffer_sub_data(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data);
+    void copy_buffer(GLuint source, GLuint destination, GLintptr source_offset, GLintptr destination_offset, GLsizeiptr size);
+    void bind_storage(GLuint binding, GLuint buffer);
+
+    void* create_mapped_storage(GLuint buffer, GLsizeiptr size);
+    void unmap(GLuint buffer);
+
+    GLsync insert_fence();
+    void wait_fence(GLsync fence);
+    void delete_fence(GLsync fence);
+    void finish();
+
+    // clear the recorded calls and the stats, buffers are kept
+    void reset_stats();
+    // content of a buffer, nullptr if it does not exist
+    std::vector<char>* get_data(GLuint buffer);
+    // buffer bound to a shader storage binding point, 0 if none
+    GLuint get_binding(GLuint binding);
+    unsigned int get_buffer_count();
+};
+
+#endif
\ No newline at end of file
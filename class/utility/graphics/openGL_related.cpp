@@ -16,6 +16,17 @@ MessageCallback( GLenum source,
             type, severity, message );
 }
 
+unsigned int gl_call_count = 0;
+void count_gl_calls(unsigned int count) {
+    gl_call_count += count;
+}
+unsigned int get_gl_call_count() {
+    return gl_call_count;
+}
+void reset_gl_call_count() {
+    gl_call_count = 0;
+}
+
 void init_OpenGL() {
     // Initialize GLEW
     glewExperimental = GL_TRUE; // Enable GLEW experimental features
@@ -83,42 +94,6 @@ void printShaderLog(GLuint shader) {
         printf("Name %d is not a shader\n", shader);
     }
 }
-bool initGL(GLuint *gProgramID, GLint *gVertexPos2DLocation, GLuint *gVBO, GLuint *gIBO, std::string& vertex_shader_source, std::string& fragment_shader_source, const GLchar* render_shader) {
-    *gProgramID = glCreateProgram();
-
-    if (!set_vertex_shader(gProgramID, "./shader/vertex.vert", vertex_shader_source)) {
-        return false;
-    }
-
-    if (!set_fragment_shader(gProgramID, render_shader, fragment_shader_source)) {
-        return false;
-    }
-
-    glLinkProgram(*gProgramID);
-
-    // check if program is valid 
-    GLint programSuccess = GL_TRUE;
-    glGetProgramiv(*gProgramID, GL_LINK_STATUS, &programSuccess);
-    if (programSuccess != GL_TRUE) {
-        printf("Error linking program %d!\n", *gProgramID);
-        printProgramLog(*gProgramID);
-        return false;
-    }
-    
-    *gVertexPos2DLocation = glGetAttribLocation(*gProgramID, "LVertexPos2D");
-
-    if (*gVertexPos2DLocation == -1) {
-        printf("LVertexPos2D is not a valid glsl program variable!\n");
-        return false;
-    }
-    glClearColor(0.f, 0.f, 0.f, 1.f);
-
-
-    set_quad_buffer(gProgramID, gVertexPos2DLocation, gVBO, gIBO);
-    
-    return true;
-}
-
 std::string get_file_text(std::string path) {
     std::ifstream file = std::ifstream(path);
 
@@ -137,52 +112,53 @@ std::string get_file_text(std::string path) {
     content += "\0";
     return content;
 }
-bool set_vertex_shader(GLuint *gProgramID, std::string path, std::string& vertex_shader_source) {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
 
-    vertex_shader_source = get_file_text(path);
-    const GLchar* shader_source = vertex_shader_source.c_str();
+bool has_parallel_shader_compile() {
+    return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+}
+void enable_parallel_shader_compile() {
+    // let the driver pick the number of threads
+    if (GLEW_KHR_parallel_shader_compile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    else if (GLEW_ARB_parallel_shader_compile) glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+}
+bool is_program_completed(GLuint program) {
+    if (!has_parallel_shader_compile()) return true;
 
-    glShaderSource(vertexShader, 1, &shader_source, NULL);
-    glCompileShader(vertexShader);
+    GLint completed = GL_TRUE;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
+}
 
-    GLint vShaderCompiled = GL_FALSE;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &vShaderCompiled);
+GLuint start_shader(GLenum type, const std::string& source) {
+    GLuint shader = glCreateShader(type);
 
-    if (vShaderCompiled != GL_TRUE) {
-        printf("Unable to compile vertex shader %d", &vShaderCompiled);
-        printShaderLog(vertexShader);
+    const GLchar* shader_source = source.c_str();
+    glShaderSource(shader, 1, &shader_source, NULL);
+    glCompileShader(shader);
 
+    return shader;
+}
+bool check_shader(GLuint shader) {
+    GLint compiled = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+    if (compiled != GL_TRUE) {
+        printf("Unable to compile shader %d!\n", shader);
+        printShaderLog(shader);
         return false;
     }
-    else {
-        glAttachShader(*gProgramID, vertexShader);
-
-        return true;
-    }
+    return true;
 }
-bool set_fragment_shader(GLuint *gProgramID, std::string path, std::string& fragment_shader_source) {
-    GLuint fragmentShader = glCreateShader( GL_FRAGMENT_SHADER );
-
-    fragment_shader_source = get_file_text(path);
-    const GLchar* shader_source = fragment_shader_source.c_str();
-
-    glShaderSource(fragmentShader, 1, &shader_source, NULL);
-    glCompileShader(fragmentShader);
-
-    GLint fShaderCompiled = GL_FALSE;
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &fShaderCompiled);
-    if(fShaderCompiled != GL_TRUE) {
-        printf("Unable to compile fragment shader %d!\n", fragmentShader);
-        printShaderLog(fragmentShader);
+bool check_program(GLuint program) {
+    GLint linked = GL_TRUE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked != GL_TRUE) {
+        printf("Error linking program %d!\n", program);
+        printProgramLog(program);
         return false;
     }
-    else {
-        glAttachShader(*gProgramID, fragmentShader);
-
-        return true;
-    }
+    return true;
 }
+
 void set_quad_buffer(GLuint *gProgramID, GLint *gVertexPos2DLocation, GLuint *gVBO, GLuint *gIBO) {
     GLfloat vertexData[] = {
         -1, -1,
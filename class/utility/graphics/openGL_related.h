@@ -10,14 +10,28 @@
 
 void init_OpenGL();
 
+// gl calls made by the engine (screen and buffers), to follow the cost of a frame
+void count_gl_calls(unsigned int count = 1);
+unsigned int get_gl_call_count();
+void reset_gl_call_count();
+
 // handling for program log
 void printProgramLog(GLuint program);
 // handling for shader log
 void printShaderLog(GLuint shader);
-bool initGL(GLuint *gProgramID, GLint *gVertexPos2DLocation, GLuint *gVBO, GLuint *gIBO, std::string& vertex_shader_source, std::string& fragment_shader_source, const GLchar* render_shader);
+std::string get_file_text(std::string path);
+
+// KHR or ARB_parallel_shader_compile: compile and link return right away, the driver works in the background
+bool has_parallel_shader_compile();
+void enable_parallel_shader_compile();
+// true once the link is done (always true without parallel compilation)
+bool is_program_completed(GLuint program);
 
-bool set_vertex_shader(GLuint *gProgramID, std::string path, std::string& vertex_shader_source);
-bool set_fragment_shader(GLuint *gProgramID, std::string path, std::string& fragment_shader_source);
+// compile without asking for the result, so it does not wait for the driver
+GLuint start_shader(GLenum type, const std::string& source);
+// wait for the result and print the log on failure
+bool check_shader(GLuint shader);
+bool check_program(GLuint program);
 void set_quad_buffer(GLuint *gProgramID, GLint *gVertexPos2DLocation, GLuint *gVBO, GLuint *gIBO);
 
 #endif
\ No newline at end of file
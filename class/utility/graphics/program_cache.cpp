@@ -0,0 +1,84 @@
+#ifndef _PROGRAM_CACHE_CLASS
+
+#include "./program_cache.h"
+
+ProgramCache::ProgramCache(std::string directory) {
+    this->directory = directory;
+}
+bool ProgramCache::is_enabled() {
+    if (this->directory.empty()) return false;
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+uint64_t ProgramCache::hash(const std::string& text, uint64_t seed) {
+    uint64_t result = seed;
+    for (unsigned char c : text)
+    {
+        result ^= c;
+        result *= 1099511628211ULL;
+    }
+    return result;
+}
+uint64_t ProgramCache::get_key(const std::string& vertex_source, const std::string& fragment_source) {
+    uint64_t key = ProgramCache::hash(vertex_source);
+    key = ProgramCache::hash(fragment_source, key);
+
+    const GLenum driver_strings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+    for (GLenum name : driver_strings)
+    {
+        const GLubyte* text = glGetString(name);
+        if (text != NULL) key = ProgramCache::hash(std::string((const char*)text), key);
+    }
+    return key;
+}
+
+bool ProgramCache::load(GLuint program, std::string name, uint64_t key) {
+    if (!this->is_enabled()) return false;
+
+    std::ifstream file = std::ifstream(this->directory + name + ".bin", std::ios::binary);
+    if (!file.is_open()) return false;
+
+    uint64_t file_key = 0;
+    GLenum format = 0;
+    GLint length = 0;
+    file.read((char*)&file_key, sizeof(file_key));
+    file.read((char*)&format, sizeof(format));
+    file.read((char*)&length, sizeof(length));
+    if (!file || file_key != key || length <= 0) return false;
+
+    std::vector<char> binary = std::vector<char>(length);
+    file.read(&binary[0], length);
+    if (!file) return false;
+
+    // the driver can still refuse it (other gpu, driver update with the same version string)
+    glProgramBinary(program, format, &binary[0], length);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    return linked == GL_TRUE;
+}
+bool ProgramCache::save(GLuint program, std::string name, uint64_t key) {
+    if (!this->is_enabled()) return false;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return false;
+
+    std::vector<char> binary = std::vector<char>(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, &binary[0]);
+
+    std::ofstream file = std::ofstream(this->directory + name + ".bin", std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "cannot write the program cache in " << this->directory << "\n";
+        return false;
+    }
+    file.write((char*)&key, sizeof(key));
+    file.write((char*)&format, sizeof(format));
+    file.write((char*)&length, sizeof(length));
+    file.write(&binary[0], length);
+    return (bool)file;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef _PROGRAM_CACHE_CLASS
+#define _PROGRAM_CACHE_CLASS
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <GL/glew.h>
+#include <SDL_opengl.h>
+
+// linked programs saved on disk with glGetProgramBinary, one file per program name
+// a file is only used if its key matches: hash of the sources and of the driver strings
+class ProgramCache
+{
+private:
+    std::string directory = "";
+public:
+    // directory must end with a separator, an empty directory disables the cache
+    ProgramCache(std::string directory = "");
+    bool is_enabled();
+
+    // fnv-1a 64 bits
+    static uint64_t hash(const std::string& text, uint64_t seed = 14695981039346656037ULL);
+    // sources and driver (vendor, renderer, version) so an update of either invalidates the binary
+    static uint64_t get_key(const std::string& vertex_source, const std::string& fragment_source);
+
+    // true if program was linked from the cached binary
+    bool load(GLuint program, std::string name, uint64_t key);
+    // program must be linked, with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set before linking
+    bool save(GLuint program, std::string name, uint64_t key);
+};
+
+#endif
\ No newline at end of file
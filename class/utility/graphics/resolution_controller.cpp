@@ -0,0 +1,41 @@
+#ifndef _RESOLUTION_CONTROLLER_CLASS
+
+#include "./resolution_controller.h"
+
+ResolutionController::ResolutionController(float target_time) {
+    this->target_time = target_time;
+}
+
+void ResolutionController::update(float frame_time, float measured_scale) {
+    if (this->is_fixed() || frame_time <= 0 || measured_scale <= 0) return;
+    if (frame_time <= this->target_time && frame_time >= this->target_time * RESOLUTION_LOW_THRESHOLD) return;
+
+    float wanted = measured_scale * sqrtf(this->target_time / frame_time);
+    this->scale += (wanted - this->scale) * RESOLUTION_SMOOTHING;
+    this->scale = fminf(RESOLUTION_MAX_SCALE, fmaxf(RESOLUTION_MIN_SCALE, this->scale));
+}
+float ResolutionController::get_scale() {
+    if (this->is_fixed()) return this->fixed_scale;
+    return this->scale;
+}
+
+void ResolutionController::set_target_time(float target_time) {
+    this->target_time = target_time;
+}
+float ResolutionController::get_target_time() {
+    return this->target_time;
+}
+
+void ResolutionController::set_fixed_scale(float scale) {
+    if (scale <= 0) {
+        this->fixed_scale = 0;
+        return;
+    }
+    this->fixed_scale = fminf(RESOLUTION_MAX_SCALE, fmaxf(RESOLUTION_MIN_SCALE, scale));
+    this->scale = this->fixed_scale;
+}
+bool ResolutionController::is_fixed() {
+    return this->fixed_scale > 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef _RESOLUTION_CONTROLLER_CLASS
+#define _RESOLUTION_CONTROLLER_CLASS
+
+#include <cmath>
+
+#define RESOLUTION_MIN_SCALE 0.25f
+#define RESOLUTION_MAX_SCALE 1.0f
+// gpu time of the scene, under the 60 fps vsync interval to leave room for the rest of the frame
+#define RESOLUTION_TARGET_TIME (1.0f / 72)
+// the scale only moves when the frame is over the target or under this part of it (avoids oscillating)
+#define RESOLUTION_LOW_THRESHOLD 0.8f
+// part of the correction applied each frame
+#define RESOLUTION_SMOOTHING 0.25f
+
+// picks the render scale (per axis) so the scene fits in the frame time budget
+// the cost of a frame is taken as proportional to its pixel count (scale squared)
+class ResolutionController
+{
+private:
+    float target_time = RESOLUTION_TARGET_TIME;
+    float scale = RESOLUTION_MAX_SCALE;
+    // 0 when the scale is dynamic
+    float fixed_scale = 0;
+public:
+    ResolutionController(float target_time = RESOLUTION_TARGET_TIME);
+
+    // frame_time: seconds the gpu took for a frame rendered at measured_scale (measured some frames ago)
+    void update(float frame_time, float measured_scale);
+    float get_scale();
+
+    void set_target_time(float target_time);
+    float get_target_time();
+
+    // override for benchmarks, 0 gives the control back
+    void set_fixed_scale(float scale);
+    bool is_fixed();
+};
+
+#endif
\ No newline at end of file
@@ -30,76 +30,386 @@ Screen::Screen(unsigned int width, unsigned int height)
     }
 }
 
+// name of a permutation in the program cache
+std::string get_variant_name(std::string program_name, const ShaderDefines& defines) {
+    if (defines.empty()) return program_name;
+    return program_name + "." + ShaderPreprocessor::get_permutation_name(defines);
+}
+// MAX_BOUNCE of a permutation, any QUALITY above 1 bounces like the highest one
+unsigned int get_compute_bounces(const ShaderDefines& defines) {
+    const unsigned int bounces[3] = COMPUTE_BOUNCES;
+    ShaderDefines::const_iterator quality = defines.find("QUALITY");
+    if (quality == defines.end()) return bounces[2];
+    int level = std::atoi(quality->second.c_str());
+    return (level == 0 || level == 1) ? bounces[level] : bounces[2];
+}
 void Screen::setup_base_shaders(const GLchar* render_shader) {
+    this->start_base_shaders(render_shader);
+    this->finish_base_shaders();
+}
+void Screen::start_base_shaders(const GLchar* render_shader) {
     this->context = SDL_GL_CreateContext(window);
     if (!context) {
         std::cerr << "SDL OpenGL context creation failed: " << SDL_GetError() << std::endl;
         exit(EXIT_FAILURE);
     }
     init_OpenGL();
+    this->shader_start = std::chrono::steady_clock::now();
+
+    this->vertex_shader_source = get_file_text("./shader/vertex.vert");
+    this->fragment_shader_path = render_shader;
+    if (!this->preprocessor.process(this->fragment_shader_path, this->shader_defines, this->fragment_shader_source)) {
+        std::cerr << "Unable to read the render shader!" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    this->gProgramID = glCreateProgram();
+
+    // one cache file per render shader
+    char* cache_directory = SDL_GetPrefPath("VoxelEngine", "program_cache");
+    this->program_cache = ProgramCache(cache_directory != NULL ? cache_directory : "");
+    SDL_free(cache_directory);
+    this->program_name = render_shader;
+    this->program_name = this->program_name.substr(this->program_name.find_last_of("/\\") + 1);
+    this->variant_name = get_variant_name(this->program_name, this->shader_defines);
+    this->program_key = ProgramCache::get_key(this->vertex_shader_source, this->fragment_shader_source);
+
+    this->program_from_cache = this->program_cache.load(this->gProgramID, this->variant_name, this->program_key);
+    if (this->program_from_cache) return;
 
-    //Initialize OpenGL
-    if (!initGL(&this->gProgramID, &this->gVertexPos2DLocation, &this->gVBO, &this->gIBO, this->vertex_shader_source, this->fragment_shader_source, render_shader)) {
-        std::cerr << "Unable to initialize OpenGL!" << std::endl;
+    enable_parallel_shader_compile();
+    this->vertex_shader = start_shader(GL_VERTEX_SHADER, this->vertex_shader_source);
+    this->fragment_shader = start_shader(GL_FRAGMENT_SHADER, this->fragment_shader_source);
+    glAttachShader(this->gProgramID, this->vertex_shader);
+    glAttachShader(this->gProgramID, this->fragment_shader);
+    glProgramParameteri(this->gProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(this->gProgramID);
+}
+bool Screen::is_shader_ready() {
+    return this->program_from_cache || is_program_completed(this->gProgramID);
+}
+void Screen::finish_base_shaders() {
+    if (!this->program_from_cache) {
+        if (!check_shader(this->vertex_shader) || !check_shader(this->fragment_shader) || !check_program(this->gProgramID)) {
+            this->preprocessor.print_files();
+            std::cerr << "Unable to initialize OpenGL!" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        glDetachShader(this->gProgramID, this->vertex_shader);
+        glDetachShader(this->gProgramID, this->fragment_shader);
+        glDeleteShader(this->vertex_shader);
+        glDeleteShader(this->fragment_shader);
+        this->program_cache.save(this->gProgramID, this->variant_name, this->program_key);
+    }
+    this->variants[this->variant_name] = this->gProgramID;
+
+    this->gVertexPos2DLocation = glGetAttribLocation(this->gProgramID, "LVertexPos2D");
+    if (this->gVertexPos2DLocation == -1) {
+        std::cerr << "LVertexPos2D is not a valid glsl program variable!" << std::endl;
         exit(EXIT_FAILURE);
     }
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+    set_quad_buffer(&this->gProgramID, &this->gVertexPos2DLocation, &this->gVBO, &this->gIBO);
+    this->create_scene_target();
 
-    this->set_uniform("WindowSize", this->width, this->height);
+    this->cache_uniforms();
+    this->frame_uniforms.window_size[0] = this->width;
+    this->frame_uniforms.window_size[1] = this->height;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - this->shader_start;
+    this->shader_time = elapsed.count();
     
     // std::cout << this->vertex_shader_source << "\n\n" << this->fragment_shader_source << "\n";
 }
+void Screen::set_shader_define(const std::string& name, const std::string& value) {
+    this->shader_defines[name] = value;
+}
+bool Screen::rebuild_shaders() {
+    GLuint program = this->get_variant(this->shader_defines, false);
+    if (program == 0) return false;
+
+    this->gProgramID = program;
+    this->variant_name = get_variant_name(this->program_name, this->shader_defines);
+    this->gVertexPos2DLocation = glGetAttribLocation(this->gProgramID, "LVertexPos2D");
+    this->cache_uniforms();
+
+    // the compute program of this permutation is built (or found) right away if it is in use
+    this->compute_program = 0;
+    this->compute_failed = false;
+    if (this->compute_renderer) this->compute_renderer = this->create_compute_renderer();
+    return true;
+}
+float Screen::get_shader_time() {
+    return this->shader_time;
+}
+bool Screen::is_shader_from_cache() {
+    return this->program_from_cache;
+}
+void Screen::create_scene_target() {
+    glCreateTextures(GL_TEXTURE_2D, 1, &this->scene_texture);
+    glTextureStorage2D(this->scene_texture, 1, GL_RGBA8, this->width, this->height);
+    glTextureParameteri(this->scene_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(this->scene_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    // rgb: color, a: distance to the first hit (negative when there is nothing to reproject)
+    glCreateTextures(GL_TEXTURE_2D, 2, this->history_textures);
+    glCreateFramebuffers(2, this->scene_framebuffers);
+    const GLenum attachments[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    for (int i = 0; i < 2; i++)
+    {
+        glTextureStorage2D(this->history_textures[i], 1, GL_RGBA16F, this->width, this->height);
+        glTextureParameteri(this->history_textures[i], GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTextureParameteri(this->history_textures[i], GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glNamedFramebufferTexture(this->scene_framebuffers[i], GL_COLOR_ATTACHMENT0, this->scene_texture, 0);
+        glNamedFramebufferTexture(this->scene_framebuffers[i], GL_COLOR_ATTACHMENT1, this->history_textures[i], 0);
+        glNamedFramebufferDrawBuffers(this->scene_framebuffers[i], 2, attachments);
+        if (glCheckNamedFramebufferStatus(this->scene_framebuffers[i], GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "scene framebuffer is not complete" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // sized for the whole window, the pre-pass uses the part covering the scene
+    glCreateTextures(GL_TEXTURE_2D, 1, &this->depth_texture);
+    glTextureStorage2D(this->depth_texture, 1, GL_R32F, (this->width + DEPTH_TILE - 1) / DEPTH_TILE, (this->height + DEPTH_TILE - 1) / DEPTH_TILE);
+    glTextureParameteri(this->depth_texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(this->depth_texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glCreateFramebuffers(1, &this->depth_framebuffer);
+    glNamedFramebufferTexture(this->depth_framebuffer, GL_COLOR_ATTACHMENT0, this->depth_texture, 0);
+    if (glCheckNamedFramebufferStatus(this->depth_framebuffer, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "depth framebuffer is not complete" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    glCreateQueries(GL_TIME_ELAPSED, SCREEN_TIMER_QUERIES, this->timer_queries);
+}
+GLuint Screen::get_variant(const ShaderDefines& defines, bool compute) {
+    std::string name = get_variant_name(this->program_name, defines);
+    auto variant = this->variants.find(name);
+    if (variant != this->variants.end()) return variant->second;
+
+    std::string source;
+    if (!this->preprocessor.process(this->fragment_shader_path, defines, source)) return 0;
+
+    GLuint program = glCreateProgram();
+    uint64_t key = ProgramCache::get_key(compute ? "" : this->vertex_shader_source, source);
+    if (!this->program_cache.load(program, name, key)) {
+        std::vector<GLuint> shaders;
+        if (compute) shaders.push_back(start_shader(GL_COMPUTE_SHADER, source));
+        else {
+            shaders.push_back(start_shader(GL_VERTEX_SHADER, this->vertex_shader_source));
+            shaders.push_back(start_shader(GL_FRAGMENT_SHADER, source));
+        }
+        for (GLuint shader : shaders) glAttachShader(program, shader);
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+
+        bool built = true;
+        for (GLuint shader : shaders) built = check_shader(shader) && built;
+        built = built && check_program(program);
+        for (GLuint shader : shaders)
+        {
+            glDetachShader(program, shader);
+            glDeleteShader(shader);
+        }
+        if (!built) {
+            this->preprocessor.print_files();
+            glDeleteProgram(program);
+            return 0;
+        }
+        this->program_cache.save(program, name, key);
+    }
+
+    this->variants[name] = program;
+    return program;
+}
+bool Screen::create_compute_renderer() {
+    if (this->compute_program != 0) return true;
+    if (this->compute_failed) return false;
+    this->compute_failed = true;
+    if (!GLEW_VERSION_4_3 && !GLEW_ARB_compute_shader) {
+        std::cerr << "compute shaders are not supported, the fragment renderer is kept" << std::endl;
+        return false;
+    }
+
+    ShaderDefines defines = this->shader_defines;
+    defines["COMPUTE_RENDERER"] = "1";
+    GLuint program = this->get_variant(defines, true);
+    if (program == 0) {
+        std::cerr << "compute renderer cannot be built, the fragment renderer is kept" << std::endl;
+        return false;
+    }
+    this->compute_program = program;
+    this->compute_bounces = get_compute_bounces(defines);
+    this->compute_failed = false;
+
+    this->compute_pass_location = glGetUniformLocation(program, "compute_pass");
+    this->compute_bounce_location = glGetUniformLocation(program, "compute_bounce");
+    this->scene_size_location = glGetUniformLocation(program, "scene_size");
+    GLuint block = glGetUniformBlockIndex(program, "frame_data");
+    if (block != GL_INVALID_INDEX) glUniformBlockBinding(program, block, FRAME_UNIFORM_BINDING);
+
+    // sized for the whole window so a change of render scale never reallocates, shared by every permutation
+    if (this->ray_buffers[0] != 0) return true;
+    // the counters block holds one count and one offset per material bin, its size comes from the shader
+    GLint counter_size = 0;
+    const GLenum property = GL_BUFFER_DATA_SIZE;
+    GLuint counter_block = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, "ray_counter_layout");
+    if (counter_block != GL_INVALID_INDEX) glGetProgramResourceiv(program, GL_SHADER_STORAGE_BLOCK, counter_block, 1, &property, 1, NULL, &counter_size);
+
+    GLsizeiptr pixels = (GLsizeiptr)this->width * this->height;
+    const GLsizeiptr sizes[4] = { pixels * QUEUED_RAY_SIZE, pixels * (GLsizeiptr)sizeof(GLuint), pixels * (GLsizeiptr)sizeof(GLuint), counter_size };
+    glCreateBuffers(4, this->ray_buffers);
+    for (int i = 0; i < 4; i++) glNamedBufferData(this->ray_buffers[i], sizes[i], NULL, GL_DYNAMIC_COPY);
+    return true;
+}
+void Screen::cache_uniforms() {
+    this->uniform_locations.clear();
+
+    GLint count = 0;
+    GLint max_length = 0;
+    glGetProgramiv(this->gProgramID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(this->gProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+    std::string name = std::string(max_length, '\0');
+    for (int i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(this->gProgramID, i, max_length, &length, &size, &type, &name[0]);
+
+        // members of a block have no location
+        GLint location = glGetUniformLocation(this->gProgramID, name.c_str());
+        if (location != -1) this->uniform_locations[name.substr(0, length)] = location;
+    }
+
+    GLuint block = glGetUniformBlockIndex(this->gProgramID, "frame_data");
+    this->has_frame_block = block != GL_INVALID_INDEX;
+    if (!this->has_frame_block) return;
+
+    glUniformBlockBinding(this->gProgramID, block, FRAME_UNIFORM_BINDING);
+    if (this->frame_buffer_id == 0) {
+        glCreateBuffers(1, &this->frame_buffer_id);
+        glNamedBufferData(this->frame_buffer_id, sizeof(FrameUniforms), NULL, GL_DYNAMIC_DRAW);
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORM_BINDING, this->frame_buffer_id);
+}
+void Screen::send_frame_uniforms() {
+    if (this->has_frame_block) {
+        count_gl_calls();
+        glNamedBufferSubData(this->frame_buffer_id, 0, sizeof(FrameUniforms), &this->frame_uniforms);
+        return;
+    }
+
+    // shaders without the block, only the uniforms they declare cost a call
+    FrameUniforms& frame = this->frame_uniforms;
+    this->set_uniform("player_position", frame.player_position[0], frame.player_position[1], frame.player_position[2]);
+    this->set_uniform("player_target", frame.player_target[0], frame.player_target[1], frame.player_target[2]);
+    this->set_uniform("debug_time", frame.debug_time[0], frame.debug_time[1], frame.debug_time[2]);
+    // they do not know about render_scale, they see the scene as the window
+    this->set_uniform("WindowSize", (float)this->scene_width, (float)this->scene_height);
+    this->set_uniform("time", frame.time);
+    this->set_uniform("deltatime", frame.deltatime);
+    this->set_uniform("facing_pitch", frame.facing_pitch);
+    this->set_uniform("facing_yaw", frame.facing_yaw);
+    this->set_uniform("FOV", frame.FOV);
+}
+
+GLint Screen::get_uniform_location(const GLchar* name) {
+    auto location = this->uniform_locations.find(name);
+    if (location == this->uniform_locations.end()) return -1;
+    return location->second;
+}
 bool Screen::set_uniform(const GLchar* name, float value) {
-    int uniform = glGetUniformLocation(this->gProgramID, name);
+    GLint uniform = this->get_uniform_location(name);
     if (uniform == -1) return false;
-    glUseProgram(this->gProgramID);
-    glUniform1f(uniform, value);
-    glUseProgram(0);
+    count_gl_calls();
+    glProgramUniform1f(this->gProgramID, uniform, value);
     return true;
 }
 bool Screen::set_uniform(const GLchar* name, float x, float y) {
-    int uniform = glGetUniformLocation(this->gProgramID, name);
+    GLint uniform = this->get_uniform_location(name);
     if (uniform == -1) return false;
-    glUseProgram(this->gProgramID);
-    glUniform2f(uniform, x, y);
-    glUseProgram(0);
+    count_gl_calls();
+    glProgramUniform2f(this->gProgramID, uniform, x, y);
     return true;
 }
 bool Screen::set_uniform(const GLchar* name, float x, float y, float z) {
-    int uniform = glGetUniformLocation(this->gProgramID, name);
+    GLint uniform = this->get_uniform_location(name);
     if (uniform == -1) return false;
-    glUseProgram(this->gProgramID);
-    glUniform3f(uniform, x, y, z);
-    glUseProgram(0);
+    count_gl_calls();
+    glProgramUniform3f(this->gProgramID, uniform, x, y, z);
     return true;
 }
 bool Screen::set_uniform(const GLchar* name, Vector3 value) {
-    int uniform = glGetUniformLocation(this->gProgramID, name);
-    if (uniform == -1) return false;
-    glUseProgram(this->gProgramID);
-    glUniform3f(uniform, value.x, value.y, value.z);
-    glUseProgram(0);
-    return true;
+    return this->set_uniform(name, value.x, value.y, value.z);
 }
 bool Screen::set_uniform(const GLchar* name, int value) {
-    int uniform = glGetUniformLocation(this->gProgramID, name);
+    GLint uniform = this->get_uniform_location(name);
     if (uniform == -1) return false;
-    glUseProgram(this->gProgramID);
-    glUniform1i(uniform, value);
-    glUseProgram(0);
+    count_gl_calls();
+    glProgramUniform1i(this->gProgramID, uniform, value);
     return true;
 }
 bool Screen::set_uniform(const GLchar* name, unsigned int value) {
-    int uniform = glGetUniformLocation(this->gProgramID, name);
+    GLint uniform = this->get_uniform_location(name);
     if (uniform == -1) return false;
-    glUseProgram(this->gProgramID);
-    glUniform1ui(uniform, value);
-    glUseProgram(0);
+    count_gl_calls();
+    glProgramUniform1ui(this->gProgramID, uniform, value);
+    return true;
+}
+
+void Screen::set_player_position(Vector3 position) {
+    this->frame_uniforms.player_position[0] = position.x;
+    this->frame_uniforms.player_position[1] = position.y;
+    this->frame_uniforms.player_position[2] = position.z;
+}
+void Screen::set_player_target(Vector3 target) {
+    this->frame_uniforms.player_target[0] = target.x;
+    this->frame_uniforms.player_target[1] = target.y;
+    this->frame_uniforms.player_target[2] = target.z;
+}
+void Screen::set_facing(float pitch, float yaw) {
+    this->frame_uniforms.facing_pitch = pitch;
+    this->frame_uniforms.facing_yaw = yaw;
+}
+void Screen::set_FOV(float FOV) {
+    this->frame_uniforms.FOV = FOV;
+}
+void Screen::set_deltatime(float deltatime) {
+    this->frame_uniforms.deltatime = deltatime;
+}
+void Screen::set_debug_time(float world_time, float player_time, float render_time) {
+    this->frame_uniforms.debug_time[0] = world_time;
+    this->frame_uniforms.debug_time[1] = player_time;
+    this->frame_uniforms.debug_time[2] = render_time;
+}
+
+void Screen::set_pick_tick(unsigned int tick) {
+    this->pick_tick = tick;
+}
+bool Screen::get_pick(PickResult& pick) {
+    if (!this->has_pick) return false;
+    pick = this->last_pick;
     return true;
 }
 
 void Screen::close() {
-    //Deallocate program
-    glDeleteProgram(this->gProgramID);
+    //Deallocate programs, every permutation built
+    for (auto& variant : this->variants) glDeleteProgram(variant.second);
+    this->variants.clear();
+    if (this->frame_buffer_id != 0) glDeleteBuffers(1, &this->frame_buffer_id);
+    if (this->scene_framebuffers[0] != 0) glDeleteFramebuffers(2, this->scene_framebuffers);
+    if (this->history_textures[0] != 0) glDeleteTextures(2, this->history_textures);
+    if (this->scene_texture != 0) glDeleteTextures(1, &this->scene_texture);
+    if (this->depth_framebuffer != 0) glDeleteFramebuffers(1, &this->depth_framebuffer);
+    if (this->depth_texture != 0) glDeleteTextures(1, &this->depth_texture);
+    if (this->timer_queries[0] != 0) glDeleteQueries(SCREEN_TIMER_QUERIES, this->timer_queries);
+    if (this->ray_buffers[0] != 0) glDeleteBuffers(4, this->ray_buffers);
+    for (int i = 0; i < PICK_FRAMES; i++)
+        if (this->pick_fences[i] != nullptr) glDeleteSync(this->pick_fences[i]);
+    if (this->pick_buffers[0] != 0) glDeleteBuffers(PICK_FRAMES, this->pick_buffers);
 
     //Destroy window  
     SDL_DestroyWindow(this->window);
@@ -116,16 +426,32 @@ SDL_Window* Screen::get_window() {
 uint64_t get_time() {
     return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 }
-void Screen::render() {
-    //Clear color buffer
-    glClear(GL_COLOR_BUFFER_BIT);
+void Screen::update_render_scale() {
+    // the query of this slot was issued SCREEN_TIMER_QUERIES frames ago
+    unsigned int slot = this->timer_frame % SCREEN_TIMER_QUERIES;
+    if (this->timer_frame >= SCREEN_TIMER_QUERIES) {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(this->timer_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        count_gl_calls();
+        if (available == GL_TRUE) {
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(this->timer_queries[slot], GL_QUERY_RESULT, &nanoseconds);
+            count_gl_calls();
+            this->scene_time = nanoseconds / 1e9;
+            this->resolution_controller.update(this->scene_time, this->timer_scales[slot]);
+        }
+    }
 
-    // set time variable
-    float time = (get_time() % (1000*1000*1000)) / (1000.0 * 1000.0);
-    this->set_uniform("time", time);
-    
-    //Bind program
-    glUseProgram(this->gProgramID);
+    float scale = this->resolution_controller.get_scale();
+    this->scene_width = __max(1, (int)roundf(this->width * scale));
+    this->scene_height = __max(1, (int)roundf(this->height * scale));
+    // the rounded size, so the projection matches the pixels
+    this->frame_uniforms.render_scale = (float)this->scene_width / this->width;
+    this->timer_scales[slot] = scale;
+}
+void Screen::draw_quad() {
+    // enable, 2 binds, pointer, draw, disable
+    count_gl_calls(6);
 
     //Enable vertex position
     glEnableVertexAttribArray(this->gVertexPos2DLocation);
@@ -140,15 +466,190 @@ void Screen::render() {
 
     //Disable vertex position
     glDisableVertexAttribArray(this->gVertexPos2DLocation);
+}
+void Screen::render() {
+    this->update_render_scale();
+    // written this frame, the other one holds the last frame
+    unsigned int current = this->frame_uniforms.frame_index % 2;
 
-    //Unbind program
+    // set time variable
+    this->frame_uniforms.time = (get_time() % (1000*1000*1000)) / (1000.0 * 1000.0);
+    bool depth_prepass = this->depth_prepass_enabled && this->get_uniform_location("depth_pass") != -1;
+    this->frame_uniforms.depth_prepass = depth_prepass ? 1 : 0;
+    this->send_frame_uniforms();
+
+    // the pick buffer of this frame, its last content was read or is lost
+    this->read_picks();
+    if (this->pick_buffers[0] == 0) {
+        count_gl_calls(1 + PICK_FRAMES);
+        glCreateBuffers(PICK_FRAMES, this->pick_buffers);
+        for (int i = 0; i < PICK_FRAMES; i++) glNamedBufferData(this->pick_buffers[i], sizeof(PickResult), NULL, GL_DYNAMIC_READ);
+    }
+    unsigned int pick_slot = this->pick_frame % PICK_FRAMES;
+    if (this->pick_fences[pick_slot] != nullptr) {
+        count_gl_calls();
+        glDeleteSync(this->pick_fences[pick_slot]);
+        this->pick_fences[pick_slot] = nullptr;
+    }
+    count_gl_calls();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PICK_BUFFER_BINDING, this->pick_buffers[pick_slot]);
+    this->pick_ticks[pick_slot] = this->pick_tick;
+
+    count_gl_calls();
+    glBeginQuery(GL_TIME_ELAPSED, this->timer_queries[this->timer_frame % SCREEN_TIMER_QUERIES]);
+    if (this->compute_renderer) {
+        // no pre-pass, each workgroup finds the distance of its tiles
+        this->render_compute(current);
+    }
+    else {
+        count_gl_calls();
+        glUseProgram(this->gProgramID);
+
+        if (depth_prepass) {
+            // one pixel per tile: framebuffer, viewport, draw, then the scene reads it
+            count_gl_calls(2);
+            glBindFramebuffer(GL_FRAMEBUFFER, this->depth_framebuffer);
+            glViewport(0, 0, (this->scene_width + DEPTH_TILE - 1) / DEPTH_TILE, (this->scene_height + DEPTH_TILE - 1) / DEPTH_TILE);
+            this->set_uniform("depth_pass", 1U);
+            this->draw_quad();
+            this->set_uniform("depth_pass", 0U);
+            count_gl_calls();
+            glBindTextureUnit(DEPTH_TEXTURE_UNIT, this->depth_texture);
+        }
+
+        // framebuffer, viewport, history, clear
+        count_gl_calls(4);
+        glBindFramebuffer(GL_FRAMEBUFFER, this->scene_framebuffers[current]);
+        glViewport(0, 0, this->scene_width, this->scene_height);
+        glBindTextureUnit(HISTORY_TEXTURE_UNIT, this->history_textures[1 - current]);
+        glClear(GL_COLOR_BUFFER_BIT);
+        this->draw_quad();
+    }
+
+    // unbind program, query
+    count_gl_calls(2);
     glUseProgram(0);
+    glEndQuery(GL_TIME_ELAPSED);
+    this->timer_frame++;
+
+    // the pick is read with glGetNamedBufferSubData: barrier, fence
+    count_gl_calls(2);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    this->pick_fences[pick_slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    this->pick_frame++;
+
+    // stretch the scene to the window: framebuffer, viewport, blit
+    count_gl_calls(3);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, this->width, this->height);
+    glBlitNamedFramebuffer(this->scene_framebuffers[current], 0,
+        0, 0, this->scene_width, this->scene_height,
+        0, 0, this->width, this->height,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    // what the next frame reprojects from
+    FrameUniforms& frame = this->frame_uniforms;
+    for (int i = 0; i < 3; i++) frame.previous_position[i] = frame.player_position[i];
+    frame.previous_pitch = frame.facing_pitch;
+    frame.previous_yaw = frame.facing_yaw;
+    frame.previous_render_scale = frame.render_scale;
+    frame.previous_FOV = frame.FOV;
+    frame.history_valid = 1;
+    frame.frame_index++;
+}
+void Screen::render_compute(unsigned int current) {
+    // program, the 2 images, history, 4 buffers, indirect buffer, clear, size
+    count_gl_calls(11);
+    glUseProgram(this->compute_program);
+    glBindImageTexture(0, this->scene_texture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
+    glBindImageTexture(1, this->history_textures[current], 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA16F);
+    glBindTextureUnit(HISTORY_TEXTURE_UNIT, this->history_textures[1 - current]);
+    for (int i = 0; i < 4; i++) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RAY_BUFFER_BINDING + i, this->ray_buffers[i]);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, this->ray_buffers[3]);
+    glClearNamedBufferData(this->ray_buffers[3], GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+    glProgramUniform2ui(this->compute_program, this->scene_size_location, this->scene_width, this->scene_height);
+
+    // primary rays: the pixels that are not reprojected, the rays that bounce are queued
+    count_gl_calls(2);
+    glProgramUniform1ui(this->compute_program, this->compute_pass_location, 0);
+    glDispatchCompute((this->scene_width + COMPUTE_TILE - 1) / COMPUTE_TILE, (this->scene_height + COMPUTE_TILE - 1) / COMPUTE_TILE, 1);
+
+    // the sort pass writes the size of the next dispatches in the counters, the cpu never reads it back
+    for (unsigned int bounce = 1; bounce <= this->compute_bounces; bounce++)
+    {
+        // sort, scatter, bounce: barrier, pass, dispatch each and the bounce number
+        count_gl_calls(10);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        glProgramUniform1ui(this->compute_program, this->compute_pass_location, 1);
+        glDispatchCompute(1, 1, 1);
+
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+        glProgramUniform1ui(this->compute_program, this->compute_pass_location, 2);
+        glDispatchComputeIndirect(0);
+
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        glProgramUniform1ui(this->compute_program, this->compute_pass_location, 3);
+        glProgramUniform1ui(this->compute_program, this->compute_bounce_location, bounce);
+        glDispatchComputeIndirect(0);
+    }
+
+    // the images are blitted, then sampled by the next frame
+    count_gl_calls();
+    glMemoryBarrier(GL_FRAMEBUFFER_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+}
+void Screen::read_picks() {
+    // oldest first, the fences of a later frame can't be signaled before
+    for (unsigned int i = 0; i < PICK_FRAMES; i++)
+    {
+        unsigned int slot = (this->pick_frame + i) % PICK_FRAMES;
+        if (this->pick_fences[slot] == nullptr) continue;
+
+        count_gl_calls();
+        GLenum result = glClientWaitSync(this->pick_fences[slot], 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED) return;
+
+        // done on the gpu, the read does not wait: delete, read
+        count_gl_calls(2);
+        glDeleteSync(this->pick_fences[slot]);
+        this->pick_fences[slot] = nullptr;
+        glGetNamedBufferSubData(this->pick_buffers[slot], 0, sizeof(PickResult), &this->last_pick);
+        this->last_pick.tick = this->pick_ticks[slot];
+        this->has_pick = true;
+    }
 }
 void Screen::update() {
     SDL_GL_SwapWindow(this->window);
 }
 
 
+void Screen::set_fixed_render_scale(float scale) {
+    this->resolution_controller.set_fixed_scale(scale);
+}
+void Screen::set_frame_time_target(float seconds) {
+    this->resolution_controller.set_target_time(seconds);
+}
+float Screen::get_render_scale() {
+    return this->resolution_controller.get_scale();
+}
+float Screen::get_scene_time() {
+    return this->scene_time;
+}
+void Screen::set_temporal_block(unsigned int block) {
+    this->frame_uniforms.temporal_block = __max(1U, block);
+}
+bool Screen::set_compute_renderer(bool enabled) {
+    this->compute_renderer = enabled && this->create_compute_renderer();
+    return this->compute_renderer == enabled;
+}
+bool Screen::is_compute_renderer() {
+    return this->compute_renderer;
+}
+void Screen::set_depth_prepass(bool enabled) {
+    this->depth_prepass_enabled = enabled;
+    // the uniform keeps its last value when the pre-pass stops
+    this->set_uniform("depth_pass", 0U);
+}
+
 bool Screen::is_full_screen() {
     return this->full_screen;
 }
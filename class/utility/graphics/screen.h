@@ -2,15 +2,92 @@
 #define _SCREEN_CLASS
 
 #include "./openGL_related.h"
+#include "./program_cache.h"
+#include "./shader_preprocessor.h"
+#include "./resolution_controller.h"
 #include "../math/vector3.h"
 
 #include <iostream>
 #include <chrono>
+#include <map>
+#include <string>
 #define SDL_MAIN_HANDLED
 #include <SDL.h>
 #include <GL/glew.h>
 #include <SDL_opengl.h>
 
+// uniform block "frame_data" of the render shader
+#define FRAME_UNIFORM_BINDING 0
+// texture unit of the history of the last frame
+#define HISTORY_TEXTURE_UNIT 0
+// one tile of each TEMPORAL_BLOCK x TEMPORAL_BLOCK group of tiles is traced per frame, the others are reprojected
+#define TEMPORAL_BLOCK 2
+// texture unit of the distances found by the depth pre-pass
+#define DEPTH_TEXTURE_UNIT 1
+// scene pixels per pre-pass pixel on each axis, DEPTH_TILE of the shader
+#define DEPTH_TILE 8
+// first of the 4 shader storage bindings of the compute renderer: rays, queue, sorted queue, counters
+#define RAY_BUFFER_BINDING 3
+// bytes of a QueuedRay of the shader, one per window pixel
+#define QUEUED_RAY_SIZE 64
+// scene pixels per compute workgroup on each axis
+#define COMPUTE_TILE 16
+// MAX_BOUNCE of the shader at QUALITY 0, 1 and 2 (the default), one sort, scatter and bounce pass each
+#define COMPUTE_BOUNCES { 1, 2, 3 }
+// shader storage binding of pick_layout (the crosshair ray), after the material buffer
+#define PICK_BUFFER_BINDING 8
+// pick buffers in flight, each is read once the gpu is done with its frame
+#define PICK_FRAMES 3
+
+// values changing every frame, std140 layout of frame_data (a vec3 followed by a float fills 16 bytes)
+struct FrameUniforms
+{
+    GLfloat player_position[3] = { 0, 0, 0 };
+    GLfloat time = 0;
+    GLfloat player_target[3] = { 0, 0, 0 };
+    GLfloat deltatime = 0;
+    GLfloat debug_time[3] = { 0, 0, 0 };
+    GLfloat facing_pitch = 0;
+    GLfloat window_size[2] = { 0, 0 };
+    GLfloat facing_yaw = 0;
+    GLfloat FOV = 0;
+    // scene pixels per window pixel
+    GLfloat render_scale = 1;
+    // camera of the history, for the reprojection
+    GLfloat previous_pitch = 0;
+    GLfloat previous_yaw = 0;
+    GLfloat previous_render_scale = 1;
+    GLfloat previous_position[3] = { 0, 0, 0 };
+    GLuint frame_index = 0;
+    // 1 traces every pixel
+    GLuint temporal_block = TEMPORAL_BLOCK;
+    // 0 when there is no usable history (first frame)
+    GLuint history_valid = 0;
+    GLfloat previous_FOV = 0;
+    // 1 when the depth pre-pass ran this frame
+    GLuint depth_prepass = 0;
+};
+
+// std430 Pick of the render shader: what the ray under the crosshair hit
+struct PickResult
+{
+    GLfloat hit_point[3] = { 0, 0, 0 };
+    GLfloat distance = 0;
+    GLfloat normal[3] = { 0, 0, 0 };
+    GLuint value = 0;
+    // camera of the frame
+    GLfloat origin[3] = { 0, 0, 0 };
+    GLfloat pitch = 0;
+    GLfloat yaw = 0;
+    GLuint has_hit = 0;
+    GLuint frame = 0;
+    // given by set_pick_tick for the frame, not written by the shader
+    GLuint tick = 0;
+};
+static_assert(sizeof(PickResult) == 64, "PickResult has the std430 layout of Pick");
+
+// gpu timer queries in flight, read a few frames later so they never stall
+#define SCREEN_TIMER_QUERIES 4
 
 class Screen
 {
@@ -25,6 +102,86 @@ private:
 
     std::string vertex_shader_source = "";
     std::string fragment_shader_source = "";
+    std::string fragment_shader_path = "";
+    ShaderDefines shader_defines;
+    // files of the last preprocessed source, printed with the compile errors
+    ShaderPreprocessor preprocessor;
+
+    ProgramCache program_cache;
+    // file name of the render shader, a variant adds its permutation
+    std::string program_name = "";
+    std::string variant_name = "";
+    uint64_t program_key = 0;
+    // linked programs by variant name, switching back to a permutation costs nothing
+    std::map<std::string, GLuint> variants;
+    bool program_from_cache = false;
+    GLuint vertex_shader = 0;
+    GLuint fragment_shader = 0;
+    std::chrono::steady_clock::time_point shader_start;
+    float shader_time = 0;
+
+    // resolved once after linking
+    std::map<std::string, GLint> uniform_locations;
+    // written by the setters, sent once per frame by render
+    FrameUniforms frame_uniforms;
+    GLuint frame_buffer_id = 0;
+    // false if the shader has no frame_data block, the values then go through plain uniforms
+    bool has_frame_block = false;
+
+    void cache_uniforms();
+    void send_frame_uniforms();
+
+    // the scene is drawn in the bottom left part of a window sized texture, then stretched to the window
+    // scene_texture is shown, the history (color and hit distance) of a frame is read by the next one
+    GLuint scene_framebuffers[2] = { 0, 0 };
+    GLuint history_textures[2] = { 0, 0 };
+    GLuint scene_texture = 0;
+    // one pixel per tile of the scene: distance its rays can skip
+    GLuint depth_framebuffer = 0;
+    GLuint depth_texture = 0;
+    bool depth_prepass_enabled = true;
+    int scene_width = 0;
+    int scene_height = 0;
+    ResolutionController resolution_controller;
+    GLuint timer_queries[SCREEN_TIMER_QUERIES] = { 0 };
+    float timer_scales[SCREEN_TIMER_QUERIES] = { 0 };
+    unsigned int timer_frame = 0;
+    float scene_time = 0;
+
+    // same program as the fragment path built as a compute shader, the primary rays then one wave per bounce
+    // rays still bouncing are queued and sorted by the material they hit before the next wave
+    bool compute_renderer = false;
+    bool compute_failed = false;
+    GLuint compute_program = 0;
+    GLint compute_pass_location = -1;
+    GLint compute_bounce_location = -1;
+    GLint scene_size_location = -1;
+    // waves after the primary rays, the MAX_BOUNCE of the permutation of compute_program
+    unsigned int compute_bounces = 0;
+    GLuint ray_buffers[4] = { 0 };
+
+    // written by the shader each frame, read back without waiting once the fence of the frame is signaled
+    GLuint pick_buffers[PICK_FRAMES] = { 0 };
+    GLsync pick_fences[PICK_FRAMES] = { nullptr };
+    GLuint pick_ticks[PICK_FRAMES] = { 0 };
+    unsigned int pick_frame = 0;
+    GLuint pick_tick = 0;
+    PickResult last_pick;
+    bool has_pick = false;
+    // read every finished pick buffer, the newest is kept
+    void read_picks();
+
+    // the program of a permutation: already linked, from the program cache or compiled now, 0 if it fails
+    GLuint get_variant(const ShaderDefines& defines, bool compute);
+    // built on first use, false if the driver has no compute shaders or the build failed
+    bool create_compute_renderer();
+    void render_compute(unsigned int current);
+
+    void create_scene_target();
+    // the screen quad with the current framebuffer and viewport
+    void draw_quad();
+    // read the oldest timer query and let the controller pick the scale of this frame
+    void update_render_scale();
 
     bool full_screen = false;
 public:
@@ -33,22 +190,64 @@ public:
 
     Screen(unsigned int width, unsigned int height);
     void close();
+    // start_base_shaders then finish_base_shaders
     void setup_base_shaders(const GLchar* render_shader);
+    // create the context and start building the program, from the cache or in the background when the driver can
+    void start_base_shaders(const GLchar* render_shader);
+    // the program can be finished without waiting
+    bool is_shader_ready();
+    // wait for the program, cache it and set up the quad and uniforms
+    void finish_base_shaders();
+    // seconds between start_base_shaders and the end of finish_base_shaders
+    float get_shader_time();
+    bool is_shader_from_cache();
+    // injected in the render shader (see ShaderPreprocessor), read by start_base_shaders and rebuild_shaders
+    void set_shader_define(const std::string& name, const std::string& value);
+    // switch to the permutation of the current defines, false (old program kept) if it can't be built
+    bool rebuild_shaders();
 
     SDL_Window* get_window();
 
     void render();
     void update();
 
+    // 0 gives the scale back to the frame time controller
+    void set_fixed_render_scale(float scale);
+    void set_frame_time_target(float seconds);
+    float get_render_scale();
+    // gpu seconds of the last measured scene
+    float get_scene_time();
+    // 1 disables the temporal reprojection
+    void set_temporal_block(unsigned int block);
+    // only used if the shader has a depth_pass uniform
+    void set_depth_prepass(bool enabled);
+    // false if the compute renderer can't be used, the fragment path is kept
+    bool set_compute_renderer(bool enabled);
+    bool is_compute_renderer();
+
     bool is_full_screen();
     void set_full_screen(bool full);
 
+    // -1 if the shader has no such uniform
+    GLint get_uniform_location(const GLchar* name);
     bool set_uniform(const GLchar* name, float value);
     bool set_uniform(const GLchar* name, float x, float y);
     bool set_uniform(const GLchar* name, float x, float y, float z);
     bool set_uniform(const GLchar* name, Vector3 value);
     bool set_uniform(const GLchar* name, int value);
     bool set_uniform(const GLchar* name, unsigned int value);
+
+    // per frame values, no gl call until the next render
+    void set_player_position(Vector3 position);
+    void set_player_target(Vector3 target);
+    void set_facing(float pitch, float yaw);
+    void set_FOV(float FOV);
+    void set_deltatime(float deltatime);
+    void set_debug_time(float world_time, float player_time, float render_time);
+    // kept with the pick of the next frames, to know which state they saw
+    void set_pick_tick(unsigned int tick);
+    // the last pick the gpu finished (a frame or more ago), false if none yet
+    bool get_pick(PickResult& pick);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef _SHADER_PREPROCESSOR_CLASS
+
+#include "./shader_preprocessor.h"
+
+bool ShaderPreprocessor::append_file(const std::string& path, std::string& output) {
+    for (const std::string& parent : this->include_stack)
+    {
+        if (parent != path) continue;
+        std::cerr << "shader " << path << " includes itself" << std::endl;
+        return false;
+    }
+    for (const std::string& file : this->files)
+        if (file == path) return true;
+
+    std::ifstream file = std::ifstream(path);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open the shader at " << path << std::endl;
+        return false;
+    }
+
+    size_t number = this->files.size();
+    this->files.push_back(path);
+    this->include_stack.push_back(path);
+    std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+
+    std::string line;
+    unsigned int line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+            output += line + "\n";
+            continue;
+        }
+
+        size_t name_start = line.find('"', start);
+        size_t name_end = (name_start == std::string::npos) ? name_start : line.find('"', name_start + 1);
+        if (name_end == std::string::npos) {
+            std::cerr << path << ":" << line_number << ": #include needs a \"file\"" << std::endl;
+            return false;
+        }
+
+        std::string include = line.substr(name_start + 1, name_end - name_start - 1);
+        output += "#line 1 " + std::to_string(this->files.size()) + "\n";
+        if (!this->append_file(directory + include, output)) return false;
+        // back to the line after the #include
+        output += "#line " + std::to_string(line_number + 1) + " " + std::to_string(number) + "\n";
+    }
+
+    this->include_stack.pop_back();
+    return true;
+}
+
+bool ShaderPreprocessor::process(const std::string& path, const ShaderDefines& defines, std::string& output) {
+    this->files.clear();
+    this->include_stack.clear();
+
+    std::string source;
+    if (!this->append_file(path, source)) return false;
+
+    // the #version line has to stay first
+    size_t version_end = 0;
+    if (source.compare(0, 8, "#version") == 0) {
+        version_end = source.find('\n');
+        version_end = (version_end == std::string::npos) ? source.size() : version_end + 1;
+    }
+
+    output = source.substr(0, version_end);
+    for (auto& define : defines)
+        output += "#define " + define.first + " " + define.second + "\n";
+    if (version_end != 0) output += "#line 2 0\n";
+    output += source.substr(version_end);
+    return true;
+}
+
+const std::vector<std::string>& ShaderPreprocessor::get_files() {
+    return this->files;
+}
+void ShaderPreprocessor::print_files() {
+    for (size_t i = 0; i < this->files.size(); i++)
+        std::cerr << "source string " << i << ": " << this->files[i] << "\n";
+}
+
+std::string ShaderPreprocessor::get_permutation_name(const ShaderDefines& defines) {
+    std::string name = "";
+    for (auto& define : defines)
+    {
+        if (!name.empty()) name += ",";
+        name += define.first + "=" + define.second;
+    }
+    return name;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef _SHADER_PREPROCESSOR_CLASS
+#define _SHADER_PREPROCESSOR_CLASS
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+
+// defines injected after the #version line, sorted by name so a permutation always gives the same source
+typedef std::map<std::string, std::string> ShaderDefines;
+
+// builds the source given to the compiler: #include "file" is replaced by the file (path relative to the including file)
+// and the defines are injected, so constants known by the engine are folded by the compiler
+// #line directives keep the compiler errors on the right line, their source string number is the index in get_files
+class ShaderPreprocessor
+{
+private:
+    std::vector<std::string> files;
+    std::vector<std::string> include_stack;
+
+    bool append_file(const std::string& path, std::string& output);
+public:
+    // false if a file can't be read or includes itself, an included file is only added once
+    bool process(const std::string& path, const ShaderDefines& defines, std::string& output);
+    // files of the last process, by source string number
+    const std::vector<std::string>& get_files();
+    void print_files();
+
+    // "NAME=value,NAME=value", tells permutations apart in the program cache
+    static std::string get_permutation_name(const ShaderDefines& defines);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef _UPLOAD_RING_CLASS
+
+#include "./upload_ring.h"
+
+UploadRing::UploadRing(bool initialize, unsigned int segment_size, unsigned int segment_count, BufferDevice* device) {
+    this->device = (device != nullptr) ? device : BufferDevice::get_default();
+    if (!initialize) return;
+    this->initialized = true;
+
+    this->segment_size = segment_size - segment_size % UPLOAD_RING_ALIGNMENT;
+    this->segments = std::vector<Segment>(__max(1U, segment_count));
+
+    GLsizeiptr size = (GLsizeiptr)this->segment_size * this->segments.size();
+    this->buffer_id = this->device->create_buffer();
+    this->mapped = (char*)this->device->create_mapped_storage(this->buffer_id, size);
+
+    if (this->mapped == nullptr) {
+        std::cerr << "persistent mapped buffers not supported, uploads go through buffer_sub_data\n";
+        this->dispose();
+    }
+}
+void UploadRing::dispose() {
+    if (!this->initialized) return;
+    this->initialized = false;
+
+    for (Segment& segment : this->segments)
+    {
+        if (segment.fence != nullptr) this->device->delete_fence(segment.fence);
+        segment.fence = nullptr;
+    }
+    if (this->mapped != nullptr) this->device->unmap(this->buffer_id);
+    this->mapped = nullptr;
+    this->device->delete_buffer(this->buffer_id);
+}
+bool UploadRing::is_buffer() {
+    if (!this->initialized) return false;
+    return this->device->is_buffer(this->buffer_id);
+}
+
+UploadRegion UploadRing::allocate(GLsizeiptr size) {
+    UploadRegion region;
+    if (!this->initialized || size <= 0) return region;
+
+    GLsizeiptr aligned_size = (size + UPLOAD_RING_ALIGNMENT - 1) / UPLOAD_RING_ALIGNMENT * UPLOAD_RING_ALIGNMENT;
+
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+    #endif
+    Segment& segment = this->segments[this->current];
+    if (segment.used + aligned_size > this->segment_size) return region;
+
+    region.segment = this->current;
+    region.offset = (GLintptr)this->current * this->segment_size + segment.used;
+    region.size = size;
+    region.data = this->mapped + region.offset;
+
+    segment.used += aligned_size;
+    segment.pending++;
+    return region;
+}
+void UploadRing::copy_to(GLuint destination, GLintptr destination_offset, UploadRegion& region) {
+    if (!region.is_valid()) return;
+
+    this->device->copy_buffer(this->buffer_id, destination, region.offset, destination_offset, region.size);
+
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+    #endif
+    this->segments[region.segment].pending--;
+    this->segments[region.segment].copied = true;
+    region = UploadRegion();
+}
+void UploadRing::release(UploadRegion& region) {
+    if (!region.is_valid()) return;
+
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+    #endif
+    this->segments[region.segment].pending--;
+    region = UploadRegion();
+}
+
+void UploadRing::next_frame() {
+    this->last_stall_time = 0;
+    this->frame_count++;
+    if (!this->initialized) return;
+
+    // fences are signaled in order, the newest one covers every older copy of the segment
+    for (Segment& segment : this->segments)
+    {
+        if (!segment.copied) continue;
+        if (segment.fence != nullptr) this->device->delete_fence(segment.fence);
+        segment.fence = this->device->insert_fence();
+        segment.copied = false;
+    }
+
+    // only the main thread changes current, workers can only lower the pending count of the next segment
+    unsigned int next = (this->current + 1) % this->segments.size();
+    Segment& segment = this->segments[next];
+    {
+        #ifndef DISABLE_THREAD
+        std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+        #endif
+        // some regions are still waiting to be copied, keep filling the current segment
+        if (segment.pending != 0) return;
+    }
+
+    if (segment.fence != nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        this->device->wait_fence(segment.fence);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        this->device->delete_fence(segment.fence);
+        segment.fence = nullptr;
+        this->last_stall_time = elapsed.count();
+        this->total_stall_time += elapsed.count();
+    }
+
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+    #endif
+    segment.used = 0;
+    this->current = next;
+}
+
+float UploadRing::get_stall_time() {
+    return this->last_stall_time;
+}
+float UploadRing::get_mean_stall_time() {
+    if (this->frame_count == 0) return 0;
+    return this->total_stall_time / this->frame_count;
+}
+GLuint UploadRing::get_id() {
+    return this->buffer_id;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef _UPLOAD_RING_CLASS
+#define _UPLOAD_RING_CLASS
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+#include <GL/glew.h>
+#include <SDL_opengl.h>
+
+#include "./buffer_device.h"
+#ifndef DISABLE_THREAD
+#include "../../../mingw_stdthreads/mingw.mutex.h"
+#endif
+
+#define UPLOAD_RING_SEGMENTS 3
+// keeps every region aligned for uint / uvec4 reads
+#define UPLOAD_RING_ALIGNMENT 16
+
+// part of the ring written by the cpu, then copied to another buffer by the gpu
+struct UploadRegion
+{
+    void* data = nullptr;
+    unsigned int segment = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+
+    bool is_valid() { return this->data != nullptr; }
+};
+
+// persistent, coherent mapped buffer split in segments (one per frame in flight)
+// any thread can allocate a region and write to it, the main thread copies it gpu side
+// a segment is reused once the gpu is done with its copies (fence) and every region in it was copied or released
+class UploadRing
+{
+private:
+    struct Segment { GLsync fence = nullptr; unsigned int used = 0; unsigned int pending = 0; bool copied = false; };
+
+    bool initialized = false;
+    BufferDevice* device = nullptr;
+    GLuint buffer_id = 0;
+    char* mapped = nullptr;
+    unsigned int segment_size = 0;
+    std::vector<Segment> segments;
+    unsigned int current = 0;
+
+    #ifndef DISABLE_THREAD
+    mingw_stdthread::mutex lock;
+    #endif
+
+    float last_stall_time = 0;
+    double total_stall_time = 0;
+    unsigned int frame_count = 0;
+public:
+    UploadRing(bool initialize = false, unsigned int segment_size = 1 << 22, unsigned int segment_count = UPLOAD_RING_SEGMENTS, BufferDevice* device = nullptr);
+    void dispose();
+    bool is_buffer();
+
+    // thread safe, the region is invalid if it does not fit in the current segment
+    UploadRegion allocate(GLsizeiptr size);
+    // copy the region to destination on the gpu (main thread), the region can't be used after that
+    void copy_to(GLuint destination, GLintptr destination_offset, UploadRegion& region);
+    // give back a region that will not be copied
+    void release(UploadRegion& region);
+
+    // call once per frame (main thread): fence the copies of the last frame and move to the next free segment
+    // waits for the gpu if the next segment is still in use, this wait is the stall time
+    void next_frame();
+
+    // seconds waited in the last next_frame
+    float get_stall_time();
+    // mean seconds waited per frame since the creation
+    float get_mean_stall_time();
+    GLuint get_id();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+#ifndef _MORTON_CLASS
+
+#include "./morton.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MORTON_BMI2
+// MORTON_BATCH codes at a time with pext, see morton_bmi2.cpp
+void morton_bmi2_decode(const uint32_t* codes, int* x, int* y, int* z);
+#endif
+
+MortonKernel detect_morton_kernel() {
+    #ifdef MORTON_BMI2
+    __builtin_cpu_init();
+    // pext is microcoded before zen 3, slower than the table there
+    bool slow_pext = __builtin_cpu_is("amdfam15h") || __builtin_cpu_is("amdfam17h");
+    if (__builtin_cpu_supports("bmi2") && !slow_pext) return MortonKernel::BMI2;
+    #endif
+    return MortonKernel::Table;
+}
+static MortonKernel best_morton_kernel = detect_morton_kernel();
+static MortonKernel morton_kernel = best_morton_kernel;
+
+#pragma region Morton
+void Morton::encode(const int* x, const int* y, const int* z, uint32_t* out, unsigned int count) {
+    // the same with every kernel: a table load per axis is faster than pdep
+    for (unsigned int i = 0; i < count; i++) out[i] = Morton::encode(x[i], y[i], z[i]);
+}
+void Morton::decode(const uint32_t* codes, int* x, int* y, int* z, unsigned int count) {
+    unsigned int i = 0;
+    #ifdef MORTON_BMI2
+    if (morton_kernel == MortonKernel::BMI2) {
+        for (; i + MORTON_BATCH <= count; i += MORTON_BATCH) morton_bmi2_decode(codes + i, x + i, y + i, z + i);
+    }
+    #endif
+    for (; i < count; i++)
+    {
+        Vector3Int pos = Morton::decode(codes[i]);
+        x[i] = pos.x;
+        y[i] = pos.y;
+        z[i] = pos.z;
+    }
+}
+
+MortonKernel Morton::get_kernel() {
+    return morton_kernel;
+}
+bool Morton::set_kernel(MortonKernel kernel) {
+    if (!is_supported(kernel)) return false;
+    morton_kernel = kernel;
+    return true;
+}
+bool Morton::is_supported(MortonKernel kernel) {
+    return (int)kernel <= (int)best_morton_kernel;
+}
+#pragma endregion
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef _MORTON_CLASS
+#define _MORTON_CLASS
+
+#include <cstdint>
+
+#include "./vector3.h"
+
+// bits kept per axis, a code holds 3 * MORTON_AXIS_BITS bits
+#define MORTON_AXIS_BITS 10
+// number of codes decoded by one call to a batch kernel
+#define MORTON_BATCH 8
+
+enum class MortonKernel { Table, BMI2 };
+
+// morton (z-order) codes: the bits of x, y and z interleaved, x the highest of each group of 3
+// bit i of the code of a cell is its child code (x << 2 | y << 1 | z) in the node of size 2^(i+1)
+// so the cells of an aligned cube of width 2^n are the 8^n codes from the code of its corner
+// and an octree node of the gpu data (GPUCell) indexes its children by the same codes
+namespace Morton
+{
+    #pragma region tables
+    // axis value -> its bits spread 3 apart (bit i goes to bit 3i)
+    struct SpreadTable
+    {
+        uint32_t values[1 << MORTON_AXIS_BITS] = {};
+        constexpr SpreadTable() {
+            for (uint32_t i = 0; i < (1 << MORTON_AXIS_BITS); i++)
+            for (uint32_t bit = 0; bit < MORTON_AXIS_BITS; bit++)
+                this->values[i] |= ((i >> bit) & 1) << (3 * bit);
+        }
+    };
+    // 9 bits of code (3 levels) -> x | y << 3 | z << 6, 3 bits each
+    struct CompactTable
+    {
+        uint16_t values[512] = {};
+        constexpr CompactTable() {
+            for (uint32_t i = 0; i < 512; i++)
+            for (uint32_t level = 0; level < 3; level++)
+                this->values[i] |=
+                    (((i >> (3 * level + 2)) & 1) << level) |
+                    (((i >> (3 * level + 1)) & 1) << (level + 3)) |
+                    (((i >> (3 * level)) & 1) << (level + 6));
+        }
+    };
+    // a template so the tables can be defined in the header, one copy for the whole program
+    template <typename T = void>
+    struct Tables
+    {
+        static constexpr SpreadTable spread_table = SpreadTable();
+        static constexpr CompactTable compact_table = CompactTable();
+    };
+    template <typename T> constexpr SpreadTable Tables<T>::spread_table;
+    template <typename T> constexpr CompactTable Tables<T>::compact_table;
+    #pragma endregion
+
+    #pragma region single code
+    // components in [0, 2^MORTON_AXIS_BITS[, one table lookup each
+    constexpr uint32_t encode(uint32_t x, uint32_t y, uint32_t z) {
+        return (Tables<>::spread_table.values[x] << 2) | (Tables<>::spread_table.values[y] << 1) | Tables<>::spread_table.values[z];
+    }
+    constexpr uint32_t encode(const Vector3Int& pos) {
+        return encode(pos.x, pos.y, pos.z);
+    }
+    // 3 levels per table lookup
+    constexpr Vector3Int decode(uint32_t code) {
+        uint32_t x = 0, y = 0, z = 0;
+        for (uint32_t level = 0; level < MORTON_AXIS_BITS; level += 3)
+        {
+            uint32_t packed = Tables<>::compact_table.values[(code >> (3 * level)) & 0x1ff];
+            x |= (packed & 0x7) << level;
+            y |= ((packed >> 3) & 0x7) << level;
+            z |= (packed >> 6) << level;
+        }
+        return Vector3Int(x, y, z);
+    }
+    #pragma endregion
+
+    #pragma region octree
+    // code of the child at this offset (each component 0 or 1) in its node
+    constexpr uint32_t child_code(uint32_t x, uint32_t y, uint32_t z) { return (x << 2) | (y << 1) | z; }
+    // offset (each component 0 or 1) of the child of this code in its node
+    constexpr Vector3Int child_offset(uint32_t code) { return Vector3Int((code >> 2) & 1, (code >> 1) & 1, code & 1); }
+    // code of the first cell of the child, node_cells cells (a power of 8) from the first cell of the node
+    constexpr uint32_t child(uint32_t node, uint32_t code, uint32_t node_cells) { return node + code * (node_cells >> 3); }
+    // code of the node of width 2^levels holding this cell
+    constexpr uint32_t parent(uint32_t code, uint32_t levels = 1) { return code >> (3 * levels); }
+    #pragma endregion
+
+    #pragma region batch
+    // codes of count coordinates
+    void encode(const int* x, const int* y, const int* z, uint32_t* out, unsigned int count);
+    // coordinates of count codes, MORTON_BATCH at a time with pext when the cpu has bmi2
+    void decode(const uint32_t* codes, int* x, int* y, int* z, unsigned int count);
+
+    // best kernel supported by the cpu, unless another one was forced
+    MortonKernel get_kernel();
+    // force a kernel (for benchmarks), returns false if the cpu does not support it
+    bool set_kernel(MortonKernel kernel);
+    bool is_supported(MortonKernel kernel);
+    #pragma endregion
+}
+
+#endif
@@ -0,0 +1,21 @@
+// BMI2 morton kernels, this file is compiled with -mbmi2 (see CMakeLists.txt)
+#if defined(__BMI2__)
+#include <immintrin.h>
+
+#include "./morton.h"
+
+// bits of z in a code (30 bits), y and x are the same shifted by 1 and 2
+#define MORTON_MASK_Z 0x09249249u
+#define MORTON_MASK_Y (MORTON_MASK_Z << 1)
+#define MORTON_MASK_X (MORTON_MASK_Z << 2)
+
+void morton_bmi2_decode(const uint32_t* codes, int* x, int* y, int* z) {
+    for (int i = 0; i < MORTON_BATCH; i++)
+    {
+        x[i] = _pext_u32(codes[i], MORTON_MASK_X);
+        y[i] = _pext_u32(codes[i], MORTON_MASK_Y);
+        z[i] = _pext_u32(codes[i], MORTON_MASK_Z);
+    }
+}
+
+#endif
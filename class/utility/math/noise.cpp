@@ -0,0 +1,103 @@
+#ifndef _NOISE_CLASS
+
+#include "./noise.h"
+
+namespace {
+
+#pragma region scalar lanes
+inline float floor_lanes(float v) { return floorf(v); }
+inline unsigned int to_int(float v) { return (unsigned int)(int)v; }
+inline float to_float(unsigned int v) { return (float)(int)v; }
+
+inline bool less(float a, float b) { return a < b; }
+inline bool greater_equal(float a, float b) { return a >= b; }
+inline bool bit_set(unsigned int v, unsigned int bit) { return (v & bit) != 0; }
+inline bool equals(unsigned int v, unsigned int other) { return v == other; }
+
+inline bool mask_and(bool a, bool b) { return a && b; }
+inline bool mask_or(bool a, bool b) { return a || b; }
+inline bool mask_not(bool a) { return !a; }
+
+inline float select(bool mask, float a, float b) { return mask ? a : b; }
+inline float negate_if(bool mask, float v) { return mask ? -v : v; }
+#pragma endregion
+
+}
+
+#include "./noise_kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NOISE_SIMD
+// NOISE_BATCH samples at a time, see noise_sse4.cpp and noise_avx2.cpp
+void noise_sse4_sample(const NoiseParameters& parameters, const float* x, const float* y, float* out);
+void noise_sse4_sample(const NoiseParameters& parameters, const float* x, const float* y, const float* z, float* out);
+void noise_avx2_sample(const NoiseParameters& parameters, const float* x, const float* y, float* out);
+void noise_avx2_sample(const NoiseParameters& parameters, const float* x, const float* y, const float* z, float* out);
+#endif
+
+NoiseKernel detect_noise_kernel() {
+    #ifdef NOISE_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return NoiseKernel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return NoiseKernel::SSE4;
+    #endif
+    return NoiseKernel::Scalar;
+}
+static NoiseKernel best_noise_kernel = detect_noise_kernel();
+static NoiseKernel noise_kernel = best_noise_kernel;
+
+#pragma region Noise
+Noise::Noise() {}
+Noise::Noise(unsigned int seed, NoiseType type, unsigned int octaves, float frequency) {
+    this->parameters.seed = seed;
+    this->parameters.type = type;
+    this->parameters.octaves = octaves;
+    this->parameters.frequency = frequency;
+}
+
+float Noise::sample(float x, float y) {
+    return fractal_noise<float, unsigned int>(this->parameters, x, y);
+}
+float Noise::sample(float x, float y, float z) {
+    return fractal_noise<float, unsigned int>(this->parameters, x, y, z);
+}
+
+void Noise::sample(const float* x, const float* y, float* out, unsigned int count) {
+    unsigned int i = 0;
+    #ifdef NOISE_SIMD
+    if (noise_kernel == NoiseKernel::AVX2) {
+        for (; i + NOISE_BATCH <= count; i += NOISE_BATCH) noise_avx2_sample(this->parameters, x + i, y + i, out + i);
+    }
+    else if (noise_kernel == NoiseKernel::SSE4) {
+        for (; i + NOISE_BATCH <= count; i += NOISE_BATCH) noise_sse4_sample(this->parameters, x + i, y + i, out + i);
+    }
+    #endif
+    for (; i < count; i++) out[i] = this->sample(x[i], y[i]);
+}
+void Noise::sample(const float* x, const float* y, const float* z, float* out, unsigned int count) {
+    unsigned int i = 0;
+    #ifdef NOISE_SIMD
+    if (noise_kernel == NoiseKernel::AVX2) {
+        for (; i + NOISE_BATCH <= count; i += NOISE_BATCH) noise_avx2_sample(this->parameters, x + i, y + i, z + i, out + i);
+    }
+    else if (noise_kernel == NoiseKernel::SSE4) {
+        for (; i + NOISE_BATCH <= count; i += NOISE_BATCH) noise_sse4_sample(this->parameters, x + i, y + i, z + i, out + i);
+    }
+    #endif
+    for (; i < count; i++) out[i] = this->sample(x[i], y[i], z[i]);
+}
+
+NoiseKernel Noise::get_kernel() {
+    return noise_kernel;
+}
+bool Noise::set_kernel(NoiseKernel kernel) {
+    if (!is_supported(kernel)) return false;
+    noise_kernel = kernel;
+    return true;
+}
+bool Noise::is_supported(NoiseKernel kernel) {
+    return (int)kernel <= (int)best_noise_kernel;
+}
+#pragma endregion
+
+#endif
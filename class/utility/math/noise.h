@@ -0,0 +1,45 @@
+#ifndef _NOISE_CLASS
+#define _NOISE_CLASS
+
+#include <cmath>
+
+// number of samples evaluated by one call to a simd kernel
+#define NOISE_BATCH 8
+
+enum class NoiseType { Value, Perlin, Simplex };
+enum class NoiseKernel { Scalar, SSE4, AVX2 };
+
+struct NoiseParameters
+{
+    NoiseType type = NoiseType::Perlin;
+    unsigned int seed = 0;
+    unsigned int octaves = 1;
+    float frequency = 1;
+};
+
+// seeded, deterministic gradient/value noise, results are in [-1, 1]
+// the batched functions give bit-for-bit the same results as the scalar ones whatever kernel is used
+class Noise
+{
+private:
+    NoiseParameters parameters;
+public:
+    Noise();
+    Noise(unsigned int seed, NoiseType type = NoiseType::Perlin, unsigned int octaves = 1, float frequency = 1);
+
+    // scalar reference
+    float sample(float x, float y);
+    float sample(float x, float y, float z);
+
+    // evaluate count samples, NOISE_BATCH at a time
+    void sample(const float* x, const float* y, float* out, unsigned int count);
+    void sample(const float* x, const float* y, const float* z, float* out, unsigned int count);
+
+    // best kernel supported by the cpu, unless another one was forced
+    static NoiseKernel get_kernel();
+    // force a kernel (for benchmarks), returns false if the cpu does not support it
+    static bool set_kernel(NoiseKernel kernel);
+    static bool is_supported(NoiseKernel kernel);
+};
+
+#endif
@@ -0,0 +1,67 @@
+// AVX2 noise kernels, this file is compiled with -mavx2 (see CMakeLists.txt)
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+#include "./noise.h"
+
+namespace {
+
+#pragma region 8 wide lanes
+struct F8 {
+    __m256 v;
+    F8() {}
+    F8(__m256 v): v(v) {}
+    F8(float f): v(_mm256_set1_ps(f)) {}
+};
+struct I8 {
+    __m256i v;
+    I8() {}
+    I8(__m256i v): v(v) {}
+    I8(unsigned int u): v(_mm256_set1_epi32((int)u)) {}
+};
+struct M8 {
+    __m256 v;
+    M8(__m256 v): v(v) {}
+};
+
+inline F8 operator+(F8 a, F8 b) { return _mm256_add_ps(a.v, b.v); }
+inline F8 operator-(F8 a, F8 b) { return _mm256_sub_ps(a.v, b.v); }
+inline F8 operator*(F8 a, F8 b) { return _mm256_mul_ps(a.v, b.v); }
+
+inline I8 operator+(I8 a, I8 b) { return _mm256_add_epi32(a.v, b.v); }
+inline I8 operator*(I8 a, I8 b) { return _mm256_mullo_epi32(a.v, b.v); }
+inline I8 operator^(I8 a, I8 b) { return _mm256_xor_si256(a.v, b.v); }
+inline I8 operator&(I8 a, I8 b) { return _mm256_and_si256(a.v, b.v); }
+inline I8 operator>>(I8 a, int shift) { return _mm256_srl_epi32(a.v, _mm_cvtsi32_si128(shift)); }
+
+inline F8 floor_lanes(F8 v) { return _mm256_floor_ps(v.v); }
+inline I8 to_int(F8 v) { return _mm256_cvttps_epi32(v.v); }
+inline F8 to_float(I8 v) { return _mm256_cvtepi32_ps(v.v); }
+
+inline M8 less(F8 a, F8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline M8 greater_equal(F8 a, F8 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+inline M8 bit_set(I8 v, unsigned int bit) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32((v & bit).v, I8(bit).v)); }
+inline M8 equals(I8 v, unsigned int other) { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(v.v, I8(other).v)); }
+
+inline M8 mask_and(M8 a, M8 b) { return _mm256_and_ps(a.v, b.v); }
+inline M8 mask_or(M8 a, M8 b) { return _mm256_or_ps(a.v, b.v); }
+inline M8 mask_not(M8 a) { return _mm256_xor_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+
+inline F8 select(M8 mask, F8 a, F8 b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+inline F8 negate_if(M8 mask, F8 v) { return _mm256_xor_ps(v.v, _mm256_and_ps(mask.v, _mm256_set1_ps(-0.0f))); }
+#pragma endregion
+
+}
+
+#include "./noise_kernels.h"
+
+void noise_avx2_sample(const NoiseParameters& parameters, const float* x, const float* y, float* out) {
+    F8 result = fractal_noise<F8, I8>(parameters, F8(_mm256_loadu_ps(x)), F8(_mm256_loadu_ps(y)));
+    _mm256_storeu_ps(out, result.v);
+}
+void noise_avx2_sample(const NoiseParameters& parameters, const float* x, const float* y, const float* z, float* out) {
+    F8 result = fractal_noise<F8, I8>(parameters, F8(_mm256_loadu_ps(x)), F8(_mm256_loadu_ps(y)), F8(_mm256_loadu_ps(z)));
+    _mm256_storeu_ps(out, result.v);
+}
+
+#endif
@@ -0,0 +1,302 @@
+// noise functions written once for every lane type (float, 4 and 8 wide vectors)
+// so that all kernels run the exact same sequence of float operations
+//
+// the including file must declare, for its lane types F (floats), I (unsigned ints) and M (masks):
+//   F floor_lanes(F)          I to_int(F)             F to_float(I)
+//   M less(F, F)              M greater_equal(F, F)
+//   M bit_set(I, unsigned)    M equals(I, unsigned)
+//   M mask_and(M, M)          M mask_or(M, M)         M mask_not(M)
+//   F select(M, F, F)         F negate_if(M, F)
+// and the arithmetic operators (F + - * F, I + * ^ & I, I >> int)
+//
+// everything lives in an anonymous namespace: each kernel file is compiled with its own
+// instruction set and must not share inline functions with the others through the linker
+
+#include "./noise.h"
+
+namespace {
+
+#define SIMPLEX_F2 0.36602540378f
+#define SIMPLEX_G2 0.21132486540f
+#define SIMPLEX_F3 0.33333333333f
+#define SIMPLEX_G3 0.16666666667f
+
+#pragma region helpers
+template <class F, class I>
+I noise_hash(I x, I y, I z, unsigned int seed) {
+    I h = (x * 0x8da6b343u) ^ (y * 0xd8163841u) ^ (z * 0xcb1ab31fu) ^ I(seed);
+    h = h * 0x27d4eb2du;
+    h = h ^ (h >> 15);
+    h = h * 0x2c1b3c6du;
+    h = h ^ (h >> 12);
+    return h;
+}
+// hash to [-1, 1]
+template <class F, class I>
+F noise_hash_value(I h) {
+    return to_float(h & 0xFFFFFFu) * (2.0f / 16777215.0f) - 1.0f;
+}
+template <class F>
+F noise_fade(F t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+template <class F>
+F noise_lerp(F a, F b, F t) {
+    return a + t * (b - a);
+}
+// diagonal gradients
+template <class F, class I>
+F noise_grad(I h, F x, F y) {
+    return negate_if(bit_set(h, 1), x) + negate_if(bit_set(h, 2), y);
+}
+// the 12 cube edges gradients of improved perlin noise
+template <class F, class I>
+F noise_grad(I h, F x, F y, F z) {
+    F u = select(bit_set(h, 8), y, x);
+    F v = select(equals(h & 12u, 0), y, select(equals(h & 13u, 12), x, z));
+    return negate_if(bit_set(h, 1), u) + negate_if(bit_set(h, 2), v);
+}
+#pragma endregion
+
+#pragma region value
+template <class F, class I>
+F value_noise(F x, F y, unsigned int seed) {
+    F fx = floor_lanes(x);
+    F fy = floor_lanes(y);
+    I ix = to_int(fx);
+    I iy = to_int(fy);
+    F u = noise_fade(x - fx);
+    F v = noise_fade(y - fy);
+    I iz = I(0u);
+
+    F v00 = noise_hash_value<F, I>(noise_hash<F, I>(ix, iy, iz, seed));
+    F v10 = noise_hash_value<F, I>(noise_hash<F, I>(ix + 1u, iy, iz, seed));
+    F v01 = noise_hash_value<F, I>(noise_hash<F, I>(ix, iy + 1u, iz, seed));
+    F v11 = noise_hash_value<F, I>(noise_hash<F, I>(ix + 1u, iy + 1u, iz, seed));
+    return noise_lerp(noise_lerp(v00, v10, u), noise_lerp(v01, v11, u), v);
+}
+template <class F, class I>
+F value_noise(F x, F y, F z, unsigned int seed) {
+    F fx = floor_lanes(x);
+    F fy = floor_lanes(y);
+    F fz = floor_lanes(z);
+    I ix = to_int(fx);
+    I iy = to_int(fy);
+    I iz = to_int(fz);
+    F u = noise_fade(x - fx);
+    F v = noise_fade(y - fy);
+    F w = noise_fade(z - fz);
+
+    F v000 = noise_hash_value<F, I>(noise_hash<F, I>(ix, iy, iz, seed));
+    F v100 = noise_hash_value<F, I>(noise_hash<F, I>(ix + 1u, iy, iz, seed));
+    F v010 = noise_hash_value<F, I>(noise_hash<F, I>(ix, iy + 1u, iz, seed));
+    F v110 = noise_hash_value<F, I>(noise_hash<F, I>(ix + 1u, iy + 1u, iz, seed));
+    F v001 = noise_hash_value<F, I>(noise_hash<F, I>(ix, iy, iz + 1u, seed));
+    F v101 = noise_hash_value<F, I>(noise_hash<F, I>(ix + 1u, iy, iz + 1u, seed));
+    F v011 = noise_hash_value<F, I>(noise_hash<F, I>(ix, iy + 1u, iz + 1u, seed));
+    F v111 = noise_hash_value<F, I>(noise_hash<F, I>(ix + 1u, iy + 1u, iz + 1u, seed));
+    F down = noise_lerp(noise_lerp(v000, v100, u), noise_lerp(v010, v110, u), v);
+    F up = noise_lerp(noise_lerp(v001, v101, u), noise_lerp(v011, v111, u), v);
+    return noise_lerp(down, up, w);
+}
+#pragma endregion
+
+#pragma region perlin
+template <class F, class I>
+F perlin_noise(F x, F y, unsigned int seed) {
+    F fx = floor_lanes(x);
+    F fy = floor_lanes(y);
+    I ix = to_int(fx);
+    I iy = to_int(fy);
+    F x0 = x - fx;
+    F y0 = y - fy;
+    F x1 = x0 - 1.0f;
+    F y1 = y0 - 1.0f;
+    F u = noise_fade(x0);
+    F v = noise_fade(y0);
+    I iz = I(0u);
+
+    F n00 = noise_grad(noise_hash<F, I>(ix, iy, iz, seed), x0, y0);
+    F n10 = noise_grad(noise_hash<F, I>(ix + 1u, iy, iz, seed), x1, y0);
+    F n01 = noise_grad(noise_hash<F, I>(ix, iy + 1u, iz, seed), x0, y1);
+    F n11 = noise_grad(noise_hash<F, I>(ix + 1u, iy + 1u, iz, seed), x1, y1);
+    return noise_lerp(noise_lerp(n00, n10, u), noise_lerp(n01, n11, u), v);
+}
+template <class F, class I>
+F perlin_noise(F x, F y, F z, unsigned int seed) {
+    F fx = floor_lanes(x);
+    F fy = floor_lanes(y);
+    F fz = floor_lanes(z);
+    I ix = to_int(fx);
+    I iy = to_int(fy);
+    I iz = to_int(fz);
+    F x0 = x - fx;
+    F y0 = y - fy;
+    F z0 = z - fz;
+    F x1 = x0 - 1.0f;
+    F y1 = y0 - 1.0f;
+    F z1 = z0 - 1.0f;
+    F u = noise_fade(x0);
+    F v = noise_fade(y0);
+    F w = noise_fade(z0);
+
+    F n000 = noise_grad(noise_hash<F, I>(ix, iy, iz, seed), x0, y0, z0);
+    F n100 = noise_grad(noise_hash<F, I>(ix + 1u, iy, iz, seed), x1, y0, z0);
+    F n010 = noise_grad(noise_hash<F, I>(ix, iy + 1u, iz, seed), x0, y1, z0);
+    F n110 = noise_grad(noise_hash<F, I>(ix + 1u, iy + 1u, iz, seed), x1, y1, z0);
+    F n001 = noise_grad(noise_hash<F, I>(ix, iy, iz + 1u, seed), x0, y0, z1);
+    F n101 = noise_grad(noise_hash<F, I>(ix + 1u, iy, iz + 1u, seed), x1, y0, z1);
+    F n011 = noise_grad(noise_hash<F, I>(ix, iy + 1u, iz + 1u, seed), x0, y1, z1);
+    F n111 = noise_grad(noise_hash<F, I>(ix + 1u, iy + 1u, iz + 1u, seed), x1, y1, z1);
+    F down = noise_lerp(noise_lerp(n000, n100, u), noise_lerp(n010, n110, u), v);
+    F up = noise_lerp(noise_lerp(n001, n101, u), noise_lerp(n011, n111, u), v);
+    return noise_lerp(down, up, w);
+}
+#pragma endregion
+
+#pragma region simplex
+template <class F, class I>
+F simplex_corner(I h, F x, F y) {
+    F t = 0.5f - x * x - y * y;
+    F t2 = t * t;
+    return select(less(t, 0.0f), 0.0f, t2 * t2 * noise_grad(h, x, y));
+}
+template <class F, class I>
+F simplex_corner(I h, F x, F y, F z) {
+    F t = 0.6f - x * x - y * y - z * z;
+    F t2 = t * t;
+    return select(less(t, 0.0f), 0.0f, t2 * t2 * noise_grad(h, x, y, z));
+}
+
+template <class F, class I>
+F simplex_noise(F x, F y, unsigned int seed) {
+    F s = (x + y) * SIMPLEX_F2;
+    F fi = floor_lanes(x + s);
+    F fj = floor_lanes(y + s);
+    F t = (fi + fj) * SIMPLEX_G2;
+    F x0 = x - (fi - t);
+    F y0 = y - (fj - t);
+
+    // lower or upper triangle of the skewed cell
+    auto lower = less(y0, x0);
+    F i1 = select(lower, 1.0f, 0.0f);
+    F j1 = select(lower, 0.0f, 1.0f);
+
+    F x1 = x0 - i1 + SIMPLEX_G2;
+    F y1 = y0 - j1 + SIMPLEX_G2;
+    F x2 = x0 - 1.0f + 2.0f * SIMPLEX_G2;
+    F y2 = y0 - 1.0f + 2.0f * SIMPLEX_G2;
+
+    I ii = to_int(fi);
+    I jj = to_int(fj);
+    I kk = I(0u);
+    F n0 = simplex_corner(noise_hash<F, I>(ii, jj, kk, seed), x0, y0);
+    F n1 = simplex_corner(noise_hash<F, I>(ii + to_int(i1), jj + to_int(j1), kk, seed), x1, y1);
+    F n2 = simplex_corner(noise_hash<F, I>(ii + 1u, jj + 1u, kk, seed), x2, y2);
+    return (n0 + n1 + n2) * 70.0f;
+}
+template <class F, class I>
+F simplex_noise(F x, F y, F z, unsigned int seed) {
+    F s = (x + y + z) * SIMPLEX_F3;
+    F fi = floor_lanes(x + s);
+    F fj = floor_lanes(y + s);
+    F fk = floor_lanes(z + s);
+    F t = (fi + fj + fk) * SIMPLEX_G3;
+    F x0 = x - (fi - t);
+    F y0 = y - (fj - t);
+    F z0 = z - (fk - t);
+
+    // order of the coordinates gives the traversed simplex
+    auto xy = greater_equal(x0, y0);
+    auto yz = greater_equal(y0, z0);
+    auto xz = greater_equal(x0, z0);
+    F i1 = select(mask_and(xy, xz), 1.0f, 0.0f);
+    F j1 = select(mask_and(mask_not(xy), yz), 1.0f, 0.0f);
+    F k1 = select(mask_and(mask_not(yz), mask_not(xz)), 1.0f, 0.0f);
+    F i2 = select(mask_or(xy, xz), 1.0f, 0.0f);
+    F j2 = select(mask_or(mask_not(xy), yz), 1.0f, 0.0f);
+    F k2 = select(mask_or(mask_not(yz), mask_not(xz)), 1.0f, 0.0f);
+
+    F x1 = x0 - i1 + SIMPLEX_G3;
+    F y1 = y0 - j1 + SIMPLEX_G3;
+    F z1 = z0 - k1 + SIMPLEX_G3;
+    F x2 = x0 - i2 + 2.0f * SIMPLEX_G3;
+    F y2 = y0 - j2 + 2.0f * SIMPLEX_G3;
+    F z2 = z0 - k2 + 2.0f * SIMPLEX_G3;
+    F x3 = x0 - 1.0f + 3.0f * SIMPLEX_G3;
+    F y3 = y0 - 1.0f + 3.0f * SIMPLEX_G3;
+    F z3 = z0 - 1.0f + 3.0f * SIMPLEX_G3;
+
+    I ii = to_int(fi);
+    I jj = to_int(fj);
+    I kk = to_int(fk);
+    F n0 = simplex_corner(noise_hash<F, I>(ii, jj, kk, seed), x0, y0, z0);
+    F n1 = simplex_corner(noise_hash<F, I>(ii + to_int(i1), jj + to_int(j1), kk + to_int(k1), seed), x1, y1, z1);
+    F n2 = simplex_corner(noise_hash<F, I>(ii + to_int(i2), jj + to_int(j2), kk + to_int(k2), seed), x2, y2, z2);
+    F n3 = simplex_corner(noise_hash<F, I>(ii + 1u, jj + 1u, kk + 1u, seed), x3, y3, z3);
+    return (n0 + n1 + n2 + n3) * 32.0f;
+}
+#pragma endregion
+
+#pragma region fractal
+template <class F, class I>
+F noise_octave(NoiseType type, F x, F y, unsigned int seed) {
+    switch (type)
+    {
+    case NoiseType::Value: return value_noise<F, I>(x, y, seed);
+    case NoiseType::Simplex: return simplex_noise<F, I>(x, y, seed);
+    default: return perlin_noise<F, I>(x, y, seed);
+    }
+}
+template <class F, class I>
+F noise_octave(NoiseType type, F x, F y, F z, unsigned int seed) {
+    switch (type)
+    {
+    case NoiseType::Value: return value_noise<F, I>(x, y, z, seed);
+    case NoiseType::Simplex: return simplex_noise<F, I>(x, y, z, seed);
+    default: return perlin_noise<F, I>(x, y, z, seed);
+    }
+}
+
+// sum of octaves of doubling frequency and halving amplitude, normalized back to [-1, 1]
+template <class F, class I>
+F fractal_noise(const NoiseParameters& parameters, F x, F y) {
+    x = x * parameters.frequency;
+    y = y * parameters.frequency;
+
+    F sum = 0.0f;
+    float amplitude = 1;
+    float total_amplitude = 0;
+    for (unsigned int i = 0; i < parameters.octaves; i++)
+    {
+        sum = sum + noise_octave<F, I>(parameters.type, x, y, parameters.seed + i) * amplitude;
+        total_amplitude += amplitude;
+        amplitude *= 0.5f;
+        x = x * 2.0f;
+        y = y * 2.0f;
+    }
+    return sum * (1.0f / total_amplitude);
+}
+template <class F, class I>
+F fractal_noise(const NoiseParameters& parameters, F x, F y, F z) {
+    x = x * parameters.frequency;
+    y = y * parameters.frequency;
+    z = z * parameters.frequency;
+
+    F sum = 0.0f;
+    float amplitude = 1;
+    float total_amplitude = 0;
+    for (unsigned int i = 0; i < parameters.octaves; i++)
+    {
+        sum = sum + noise_octave<F, I>(parameters.type, x, y, z, parameters.seed + i) * amplitude;
+        total_amplitude += amplitude;
+        amplitude *= 0.5f;
+        x = x * 2.0f;
+        y = y * 2.0f;
+        z = z * 2.0f;
+    }
+    return sum * (1.0f / total_amplitude);
+}
+#pragma endregion
+
+}
@@ -0,0 +1,73 @@
+// SSE4.1 noise kernels, this file is compiled with -msse4.1 (see CMakeLists.txt)
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+
+#include "./noise.h"
+
+namespace {
+
+#pragma region 4 wide lanes
+struct F4 {
+    __m128 v;
+    F4() {}
+    F4(__m128 v): v(v) {}
+    F4(float f): v(_mm_set1_ps(f)) {}
+};
+struct I4 {
+    __m128i v;
+    I4() {}
+    I4(__m128i v): v(v) {}
+    I4(unsigned int u): v(_mm_set1_epi32((int)u)) {}
+};
+struct M4 {
+    __m128 v;
+    M4(__m128 v): v(v) {}
+};
+
+inline F4 operator+(F4 a, F4 b) { return _mm_add_ps(a.v, b.v); }
+inline F4 operator-(F4 a, F4 b) { return _mm_sub_ps(a.v, b.v); }
+inline F4 operator*(F4 a, F4 b) { return _mm_mul_ps(a.v, b.v); }
+
+inline I4 operator+(I4 a, I4 b) { return _mm_add_epi32(a.v, b.v); }
+inline I4 operator*(I4 a, I4 b) { return _mm_mullo_epi32(a.v, b.v); }
+inline I4 operator^(I4 a, I4 b) { return _mm_xor_si128(a.v, b.v); }
+inline I4 operator&(I4 a, I4 b) { return _mm_and_si128(a.v, b.v); }
+inline I4 operator>>(I4 a, int shift) { return _mm_srl_epi32(a.v, _mm_cvtsi32_si128(shift)); }
+
+inline F4 floor_lanes(F4 v) { return _mm_floor_ps(v.v); }
+inline I4 to_int(F4 v) { return _mm_cvttps_epi32(v.v); }
+inline F4 to_float(I4 v) { return _mm_cvtepi32_ps(v.v); }
+
+inline M4 less(F4 a, F4 b) { return _mm_cmplt_ps(a.v, b.v); }
+inline M4 greater_equal(F4 a, F4 b) { return _mm_cmpge_ps(a.v, b.v); }
+inline M4 bit_set(I4 v, unsigned int bit) { return _mm_castsi128_ps(_mm_cmpeq_epi32((v & bit).v, I4(bit).v)); }
+inline M4 equals(I4 v, unsigned int other) { return _mm_castsi128_ps(_mm_cmpeq_epi32(v.v, I4(other).v)); }
+
+inline M4 mask_and(M4 a, M4 b) { return _mm_and_ps(a.v, b.v); }
+inline M4 mask_or(M4 a, M4 b) { return _mm_or_ps(a.v, b.v); }
+inline M4 mask_not(M4 a) { return _mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+
+inline F4 select(M4 mask, F4 a, F4 b) { return _mm_blendv_ps(b.v, a.v, mask.v); }
+inline F4 negate_if(M4 mask, F4 v) { return _mm_xor_ps(v.v, _mm_and_ps(mask.v, _mm_set1_ps(-0.0f))); }
+#pragma endregion
+
+}
+
+#include "./noise_kernels.h"
+
+void noise_sse4_sample(const NoiseParameters& parameters, const float* x, const float* y, float* out) {
+    for (int i = 0; i < NOISE_BATCH; i += 4)
+    {
+        F4 result = fractal_noise<F4, I4>(parameters, F4(_mm_loadu_ps(x + i)), F4(_mm_loadu_ps(y + i)));
+        _mm_storeu_ps(out + i, result.v);
+    }
+}
+void noise_sse4_sample(const NoiseParameters& parameters, const float* x, const float* y, const float* z, float* out) {
+    for (int i = 0; i < NOISE_BATCH; i += 4)
+    {
+        F4 result = fractal_noise<F4, I4>(parameters, F4(_mm_loadu_ps(x + i)), F4(_mm_loadu_ps(y + i)), F4(_mm_loadu_ps(z + i)));
+        _mm_storeu_ps(out + i, result.v);
+    }
+}
+
+#endif
@@ -4,6 +4,15 @@
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <cassert>
+#include <type_traits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// header only: every operator inlines into the raycast and generation loops
+// the arithmetic is constexpr and left to the compiler (it packs it in sse registers itself),
+// the rounding (floor, %) uses sse2 directly instead of one floorf call per component
 
 class Vector3Int;
 
@@ -12,110 +21,209 @@ class Vector3
 private:
 public:
     float x = 0, y = 0, z = 0;
-    
-    Vector3();
-    Vector3(const Vector3Int&);
-    Vector3(float x, float y, float z);
 
-    Vector3Int round();
-    Vector3Int floor();
+    constexpr Vector3() {}
+    constexpr Vector3(const Vector3Int&);
+    constexpr Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+    Vector3Int round() const;
+    Vector3Int floor() const;
 
-    Vector3 operator+(const Vector3& other);
-    Vector3& operator+=(const Vector3& other);
+    constexpr Vector3 operator+(const Vector3& other) const { return Vector3(this->x + other.x, this->y + other.y, this->z + other.z); }
+    constexpr Vector3& operator+=(const Vector3& other) { return *this = *this + other; }
 
-    Vector3 operator-(const Vector3& other);
-    Vector3& operator-=(const Vector3& other);
+    constexpr Vector3 operator-(const Vector3& other) const { return Vector3(this->x - other.x, this->y - other.y, this->z - other.z); }
+    constexpr Vector3& operator-=(const Vector3& other) { return *this = *this - other; }
 
     // per component multiplication
-    Vector3 operator*(const Vector3& other);
+    constexpr Vector3 operator*(const Vector3& other) const { return Vector3(this->x * other.x, this->y * other.y, this->z * other.z); }
     // per component multiplication
-    Vector3& operator*=(const Vector3& other);
-    Vector3 operator*(float scalar);
-    Vector3& operator*=(float scalar);
+    constexpr Vector3& operator*=(const Vector3& other) { return *this = *this * other; }
+    constexpr Vector3 operator*(float scalar) const { return Vector3(this->x * scalar, this->y * scalar, this->z * scalar); }
+    constexpr Vector3& operator*=(float scalar) { return *this = *this * scalar; }
 
     // per component division
-    Vector3 operator/(const Vector3& other);
+    constexpr Vector3 operator/(const Vector3& other) const { return Vector3(this->x / other.x, this->y / other.y, this->z / other.z); }
     // per component division
-    Vector3& operator/=(const Vector3& other);
-    Vector3 operator/(float scalar);
-    Vector3& operator/=(float scalar);
-
-    // per component mod
-    Vector3 operator%(float scalar);
-    // per component mod
-    Vector3& operator%=(float scalar);
-
-    // return the component at this index (0 => x, 1 => y, 2 => z)
-    // throws an error if index < 0 or index > 2
-    float& operator[](int index);
-    bool operator==(const Vector3& other);
-    bool operator!=(const Vector3& other);
+    constexpr Vector3& operator/=(const Vector3& other) { return *this = *this / other; }
+    constexpr Vector3 operator/(float scalar) const { return Vector3(this->x / scalar, this->y / scalar, this->z / scalar); }
+    constexpr Vector3& operator/=(float scalar) { return *this = *this / scalar; }
+
+    // per component mod, the result has the sign of scalar
+    Vector3 operator%(float scalar) const;
+    // per component mod, the result has the sign of scalar
+    Vector3& operator%=(float scalar) { return *this = *this % scalar; }
+
+    // return the component at this index (0 => x, 1 => y, 2 => z), without branch
+    constexpr float& operator[](int index) {
+        assert(index >= 0 && index <= 2);
+        return index == 0 ? this->x : (index == 1 ? this->y : this->z);
+    }
+    constexpr float operator[](int index) const {
+        assert(index >= 0 && index <= 2);
+        return index == 0 ? this->x : (index == 1 ? this->y : this->z);
+    }
+    constexpr bool operator==(const Vector3& other) const { return this->x == other.x && this->y == other.y && this->z == other.z; }
+    constexpr bool operator!=(const Vector3& other) const { return !(*this == other); }
 
     // return a vector othogonal to the two vectors
-    Vector3 cross(const Vector3& other);
+    constexpr Vector3 cross(const Vector3& other) const {
+        return Vector3(
+            this->y * other.z - this->z * other.y,
+            this->z * other.x - this->x * other.z,
+            this->x * other.y - this->y * other.x
+        );
+    }
     // return the dot product of the two vectors
-    float dot(const Vector3& other);
+    constexpr float dot(const Vector3& other) const { return this->x * other.x + this->y * other.y + this->z * other.z; }
     // return the length of the vector
-    float magnitude();
+    float magnitude() const { return sqrtf(this->sqrmagnitude()); }
     // return the squared length of the vector
-    float sqrmagnitude();
+    constexpr float sqrmagnitude() const { return this->dot(*this); }
     // normalize the vector in place and return itself
-    Vector3& normalize();
+    Vector3& normalize() { return *this /= this->magnitude(); }
     // return a new vector with same direction and a norm of 1
-    Vector3 normalized();
+    Vector3 normalized() const { return *this / this->magnitude(); }
 
-    std::string to_str();
+    std::string to_str() const {
+        return "(" + std::to_string(this->x) + ", " + std::to_string(this->y) + ", " + std::to_string(this->z) + ")";
+    }
 };
 
+// integer arithmetic with integers and Vector3Int, the float overloads truncate toward zero like before
 class Vector3Int
 {
 private:
+    // integer scalars are used as int (unsigned too, so negative components divide right), the others as float
+    template <typename T>
+    using Scalar = typename std::enable_if<std::is_arithmetic<T>::value, typename std::conditional<std::is_integral<T>::value, int, float>::type>::type;
 public:
     int x = 0, y = 0, z = 0;
-    
-    Vector3Int();
-    Vector3Int(const Vector3&);
-    Vector3Int(int x, int y, int z);
 
-    Vector3Int operator+(const Vector3& other);
-    Vector3Int& operator+=(const Vector3& other);
+    constexpr Vector3Int() {}
+    constexpr Vector3Int(const Vector3& other) : x((int)other.x), y((int)other.y), z((int)other.z) {}
+    constexpr Vector3Int(int x, int y, int z) : x(x), y(y), z(z) {}
+
+    constexpr Vector3Int operator+(const Vector3Int& other) const { return Vector3Int(this->x + other.x, this->y + other.y, this->z + other.z); }
+    constexpr Vector3Int& operator+=(const Vector3Int& other) { return *this = *this + other; }
+    constexpr Vector3Int operator+(const Vector3& other) const { return Vector3(*this) + other; }
+    constexpr Vector3Int& operator+=(const Vector3& other) { return *this = *this + other; }
 
-    Vector3Int operator-(const Vector3& other);
-    Vector3Int& operator-=(const Vector3& other);
+    constexpr Vector3Int operator-(const Vector3Int& other) const { return Vector3Int(this->x - other.x, this->y - other.y, this->z - other.z); }
+    constexpr Vector3Int& operator-=(const Vector3Int& other) { return *this = *this - other; }
+    constexpr Vector3Int operator-(const Vector3& other) const { return Vector3(*this) - other; }
+    constexpr Vector3Int& operator-=(const Vector3& other) { return *this = *this - other; }
 
     // per component multiplication
-    Vector3Int operator*(const Vector3& other);
+    constexpr Vector3Int operator*(const Vector3Int& other) const { return Vector3Int(this->x * other.x, this->y * other.y, this->z * other.z); }
     // per component multiplication
-    Vector3Int& operator*=(const Vector3& other);
-    Vector3Int operator*(float scalar);
-    Vector3Int& operator*=(float scalar);
-
-    // per component division
-    Vector3Int operator/(const Vector3& other);
-    // per component division
-    Vector3Int& operator/=(const Vector3& other);
-    Vector3Int operator/(float scalar);
-    Vector3Int& operator/=(float scalar);
-
-    // per component mod
-    Vector3Int operator%(int scalar);
-    // per component mod
-    Vector3Int& operator%=(int scalar);
-
-    // return the component at this index (0 => x, 1 => y, 2 => z)
-    // throws an error if index < 0 or index > 2
-    int& operator[](int index);
-    bool operator==(const Vector3Int& other);
-    bool operator!=(const Vector3Int& other);
+    constexpr Vector3Int& operator*=(const Vector3Int& other) { return *this = *this * other; }
+    constexpr Vector3Int operator*(const Vector3& other) const { return Vector3(*this) * other; }
+    constexpr Vector3Int& operator*=(const Vector3& other) { return *this = *this * other; }
+    template <typename T>
+    constexpr Vector3Int operator*(T scalar) const {
+        return Vector3Int(this->x * (Scalar<T>)scalar, this->y * (Scalar<T>)scalar, this->z * (Scalar<T>)scalar);
+    }
+    template <typename T>
+    constexpr Vector3Int& operator*=(T scalar) { return *this = *this * scalar; }
+
+    // per component division, toward zero
+    constexpr Vector3Int operator/(const Vector3Int& other) const { return Vector3Int(this->x / other.x, this->y / other.y, this->z / other.z); }
+    // per component division, toward zero
+    constexpr Vector3Int& operator/=(const Vector3Int& other) { return *this = *this / other; }
+    constexpr Vector3Int operator/(const Vector3& other) const { return Vector3(*this) / other; }
+    constexpr Vector3Int& operator/=(const Vector3& other) { return *this = *this / other; }
+    template <typename T>
+    constexpr Vector3Int operator/(T scalar) const {
+        return Vector3Int(this->x / (Scalar<T>)scalar, this->y / (Scalar<T>)scalar, this->z / (Scalar<T>)scalar);
+    }
+    template <typename T>
+    constexpr Vector3Int& operator/=(T scalar) { return *this = *this / scalar; }
+
+    // per component mod, the result has the sign of the component
+    constexpr Vector3Int operator%(int scalar) const { return Vector3Int(this->x % scalar, this->y % scalar, this->z % scalar); }
+    // per component mod, the result has the sign of the component
+    constexpr Vector3Int& operator%=(int scalar) { return *this = *this % scalar; }
+
+    // return the component at this index (0 => x, 1 => y, 2 => z), without branch
+    constexpr int& operator[](int index) {
+        assert(index >= 0 && index <= 2);
+        return index == 0 ? this->x : (index == 1 ? this->y : this->z);
+    }
+    constexpr int operator[](int index) const {
+        assert(index >= 0 && index <= 2);
+        return index == 0 ? this->x : (index == 1 ? this->y : this->z);
+    }
+    constexpr bool operator==(const Vector3Int& other) const { return this->x == other.x && this->y == other.y && this->z == other.z; }
+    constexpr bool operator!=(const Vector3Int& other) const { return !(*this == other); }
 
     // return the dot product of the two vectors
-    float dot(const Vector3& other);
+    constexpr float dot(const Vector3& other) const { return this->x * other.x + this->y * other.y + this->z * other.z; }
     // return the length of the vector
-    float magnitude();
+    float magnitude() const { return sqrtf(this->sqrmagnitude()); }
     // return the squared length of the vector
-    float sqrmagnitude();
+    constexpr float sqrmagnitude() const { return this->x * this->x + this->y * this->y + this->z * this->z; }
 
-    std::string to_str();
+    std::string to_str() const {
+        return "(" + std::to_string(this->x) + ", " + std::to_string(this->y) + ", " + std::to_string(this->z) + ")";
+    }
 };
 
+constexpr Vector3::Vector3(const Vector3Int& other) : x((float)other.x), y((float)other.y), z((float)other.z) {}
+
+#pragma region rounding
+#ifdef __SSE2__
+// floorf of each lane: truncate, then one less where that rounded up
+// (|v| >= 2^23 and nan are already integers, kept; the sign is kept for -0)
+inline __m128 floor_sse2(__m128 v) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    __m128 floored = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), _mm_set1_ps(1.0f)));
+    floored = _mm_or_ps(floored, _mm_and_ps(v, sign));
+    __m128 integral = _mm_cmpnlt_ps(_mm_andnot_ps(sign, v), _mm_set1_ps(8388608.0f));
+    return _mm_or_ps(_mm_and_ps(integral, v), _mm_andnot_ps(integral, floored));
+}
+inline Vector3 to_vector3(__m128 v) {
+    float lanes[4];
+    _mm_storeu_ps(lanes, v);
+    return Vector3(lanes[0], lanes[1], lanes[2]);
+}
+#endif
+
+inline Vector3Int Vector3::round() const {
+    return Vector3Int(
+        roundf(this->x),
+        roundf(this->y),
+        roundf(this->z)
+    );
+}
+inline Vector3Int Vector3::floor() const {
+    #ifdef __SSE2__
+    // the floored lanes are integers, the conversion is exact
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, _mm_cvttps_epi32(floor_sse2(_mm_setr_ps(this->x, this->y, this->z, 0))));
+    return Vector3Int(lanes[0], lanes[1], lanes[2]);
+    #else
+    return Vector3Int(
+        floorf(this->x),
+        floorf(this->y),
+        floorf(this->z)
+    );
+    #endif
+}
+inline Vector3 Vector3::operator%(float scalar) const {
+    #ifdef __SSE2__
+    __m128 v = _mm_setr_ps(this->x, this->y, this->z, 0);
+    __m128 s = _mm_set1_ps(scalar);
+    return to_vector3(_mm_sub_ps(v, _mm_mul_ps(floor_sse2(_mm_div_ps(v, s)), s)));
+    #else
+    return Vector3(
+        this->x - floorf(this->x / scalar) * scalar,
+        this->y - floorf(this->y / scalar) * scalar,
+        this->z - floorf(this->z / scalar) * scalar
+    );
+    #endif
+}
+#pragma endregion
+
 #endif
\ No newline at end of file
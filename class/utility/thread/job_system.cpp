@@ -0,0 +1,94 @@
+#ifndef _JOB_SYSTEM_CLASS
+
+#include "./job_system.h"
+
+JobSystem::JobSystem(int worker_count) {
+    #ifndef DISABLE_THREAD
+    if (worker_count < 0) worker_count = (int)mingw_stdthread::thread::hardware_concurrency() - 1;
+    this->worker_count = __max(0, worker_count);
+
+    for (unsigned int i = 0; i < this->worker_count; i++)
+        this->workers.push_back(mingw_stdthread::thread(&JobSystem::work, this));
+    #endif
+}
+void JobSystem::dispose() {
+    #ifndef DISABLE_THREAD
+    {
+        std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (mingw_stdthread::thread& worker : this->workers) worker.join();
+    this->workers.clear();
+    #endif
+    this->worker_count = 0;
+}
+unsigned int JobSystem::get_worker_count() {
+    return this->worker_count;
+}
+
+#ifndef DISABLE_THREAD
+void JobSystem::work() {
+    unsigned int seen = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<mingw_stdthread::mutex> guard(this->lock);
+            this->wake.wait(guard, [&]() { return this->stopping || this->job_id != seen; });
+            if (this->stopping) return;
+            seen = this->job_id;
+            this->busy++;
+        }
+        this->run_batches();
+        {
+            std::lock_guard<mingw_stdthread::mutex> guard(this->lock);
+            this->busy--;
+        }
+        this->done.notify_all();
+    }
+}
+void JobSystem::run_batches() {
+    unsigned int batch;
+    while ((batch = this->next_batch.fetch_add(1)) < this->batch_total)
+    {
+        unsigned int begin = batch * this->batch_size;
+        (*this->job)(begin, __min(begin + this->batch_size, this->job_count));
+        this->finished_batches++;
+    }
+}
+#endif
+
+void JobSystem::parallel_for(unsigned int count, unsigned int batch_size, const std::function<void(unsigned int, unsigned int)>& function) {
+    if (count == 0) return;
+    batch_size = __max(1U, batch_size);
+
+    #ifndef DISABLE_THREAD
+    // a single batch is not worth waking anyone
+    if (this->worker_count > 0 && count > batch_size) {
+        {
+            std::unique_lock<mingw_stdthread::mutex> guard(this->lock);
+            // a worker woken late by the last loop may still be looking at it
+            this->done.wait(guard, [&]() { return this->busy == 0; });
+            this->job = &function;
+            this->job_count = count;
+            this->batch_size = batch_size;
+            this->batch_total = (count + batch_size - 1) / batch_size;
+            this->next_batch = 0;
+            this->finished_batches = 0;
+            this->job_id++;
+        }
+        this->wake.notify_all();
+        this->run_batches();
+
+        std::unique_lock<mingw_stdthread::mutex> guard(this->lock);
+        this->done.wait(guard, [&]() { return this->busy == 0 && this->finished_batches == this->batch_total; });
+        this->job = nullptr;
+        return;
+    }
+    #endif
+
+    for (unsigned int begin = 0; begin < count; begin += batch_size)
+        function(begin, __min(begin + batch_size, count));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef _JOB_SYSTEM_CLASS
+#define _JOB_SYSTEM_CLASS
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#ifndef DISABLE_THREAD
+#include "../../../mingw_stdthreads/mingw.thread.h"
+#include "../../../mingw_stdthreads/mingw.mutex.h"
+#include "../../../mingw_stdthreads/mingw.condition_variable.h"
+#endif
+#include <atomic>
+
+// a few worker threads that split a loop in batches, the calling thread takes batches too
+// one loop at a time: parallel_for returns once every batch is done (all on the caller with DISABLE_THREAD)
+class JobSystem
+{
+private:
+    unsigned int worker_count = 0;
+
+    #ifndef DISABLE_THREAD
+    std::vector<mingw_stdthread::thread> workers;
+    mingw_stdthread::mutex lock;
+    // workers wait for a new loop, the caller for the last batch of its loop
+    mingw_stdthread::condition_variable wake;
+    mingw_stdthread::condition_variable done;
+    bool stopping = false;
+
+    // the loop running, only changed while no worker is busy
+    const std::function<void(unsigned int, unsigned int)>* job = nullptr;
+    unsigned int job_count = 0;
+    unsigned int batch_size = 1;
+    unsigned int batch_total = 0;
+    unsigned int job_id = 0;
+    // workers between taking the loop and giving back their batches
+    unsigned int busy = 0;
+    std::atomic_uint next_batch = {0};
+    std::atomic_uint finished_batches = {0};
+
+    void work();
+    void run_batches();
+    #endif
+public:
+    // worker_count threads besides the caller, one less than the cores if negative
+    JobSystem(int worker_count = -1);
+    JobSystem & operator=(const JobSystem&) = delete;
+    JobSystem(const JobSystem&) = delete;
+    void dispose();
+
+    unsigned int get_worker_count();
+    // function(begin, end) for every batch of batch_size indices in [0, count), in any order and on any thread
+    void parallel_for(unsigned int count, unsigned int batch_size, const std::function<void(unsigned int, unsigned int)>& function);
+};
+
+#endif
\ No newline at end of file
@@ -8,25 +8,32 @@
 #pragma region GPUCell
 
 unsigned int& GPUCell::operator[](int code) {
-    switch (code)
-    {
-    case 0: return this->cell_000;
-    case 1: return this->cell_001;
-    case 2: return this->cell_010;
-    case 3: return this->cell_011;
-    case 4: return this->cell_100;
-    case 5: return this->cell_101;
-    case 6: return this->cell_110;
-    case 7: return this->cell_111;
-    default:
+    if (code < 0 || code > 7) {
         std::cerr << "ERROR : trying to acces cell child of code " << code << "\n";
         exit(1);
     }
+    return this->children[code];
 }
 
 #pragma endregion
 
 
+#pragma region CellStorage
+CellStorage::CellStorage(unsigned int resolution_shift) {
+    unsigned int width = CHUNK_WIDTH >> resolution_shift;
+    this->cells = new Cell[width * width * width];
+    this->resolution_shift = resolution_shift;
+}
+CellStorage::~CellStorage() {
+    delete[] this->cells;
+}
+uint32_t CellStorage::index(Vector3Int pos) {
+    unsigned int shift = this->resolution_shift;
+    return Morton::encode(pos.x >> shift, pos.y >> shift, pos.z >> shift);
+}
+#pragma endregion
+
+
 #pragma region Chunk
 Chunk::Chunk() {
     this->world = nullptr;
@@ -36,15 +43,13 @@ Chunk::Chunk() {
 void Chunk::dispose() {
     this->flatten_data.clear();
 
-    if (this->cells == nullptr) return;
-
-    for (int x = 0; x < CHUNK_WIDTH; x++) {
-        for (int y = 0; y < CHUNK_WIDTH; y++) {
-            delete this->cells[x][y];
-        }
-        delete this->cells[x];
-    }
-    delete this->cells;
+    CellStorage* storage = this->storage.exchange(nullptr);
+    if (storage != nullptr) delete storage;
+}
+void Chunk::retire(CellStorage* storage) {
+    if (storage == nullptr) return;
+    if (this->world != nullptr) this->world->retire_cells(storage);
+    else delete storage;
 }
 bool Chunk::in_bounds(Vector3Int position) {
     return 
@@ -59,6 +64,12 @@ bool Chunk::in_bounds(Vector3Int position) {
 bool Chunk::is_fully_generated() {
     return this->fully_generated;
 }
+unsigned int Chunk::get_resolution() {
+    return CHUNK_RESOLUTION - this->storage.load()->resolution_shift;
+}
+CellStorage* Chunk::get_storage() {
+    return this->storage.load();
+}
 
 unsigned int Chunk::populate_gpu_data(std::vector<GPUCell>& data, Vector3Int pos, unsigned int cell_size, unsigned int min_cell_size) {
     if (cell_size < min_cell_size) return 0;
@@ -72,13 +83,9 @@ unsigned int Chunk::populate_gpu_data(std::vector<GPUCell>& data, Vector3Int pos
     if (!this->has_subcells(pos, cell_size)) return added_index;
 
     cell_size >>= 1;
-    int code = -1;
-    for (int x = 0; x <= 1; x++)
-    for (int y = 0; y <= 1; y++)
-    for (int z = 0; z <= 1; z++)
+    for (int code = 0; code < 8; code++)
     {
-        code++;
-        Vector3Int subcell_pos = pos + (Vector3Int(x, y, z) * cell_size);
+        Vector3Int subcell_pos = pos + Morton::child_offset(code) * cell_size;
         Cell* subcell = this->operator[](subcell_pos);
         
         if (!this->has_subcells(subcell_pos, cell_size) && subcell->value == cell->value) continue;
@@ -90,33 +97,37 @@ unsigned int Chunk::populate_gpu_data(std::vector<GPUCell>& data, Vector3Int pos
     return added_index;
 }
 bool Chunk::has_subcells(Vector3Int cell_pos, unsigned int cell_size) {
-    if (cell_size == 1) return false;
+    unsigned int resolution_shift = this->storage.load()->resolution_shift;
+    if (cell_size <= (1 << resolution_shift)) return false;
 
-    unsigned int type = this->get(cell_pos);
-    cell_size >>= 1;
-    for (int x = 0; x <= 1; x++)
-    for (int y = 0; y <= 1; y++)
-    for (int z = 0; z <= 1; z++)
+    // the node is a contiguous range of cells, it has subcells unless they are all the same
+    unsigned int width = cell_size >> resolution_shift;
+    Cell* first = this->operator[](cell_pos);
+    Cell* end = first + width * width * width;
+    for (Cell* cell = first + 1; cell < end; cell++)
     {
-        if (this->has_subcells(cell_pos + Vector3Int(x, y, z) * cell_size, cell_size)) return true;
-        if (this->get(cell_pos + Vector3Int(x, y, z) * cell_size) != type) return true;
+        if (cell->value != first->value) return true;
     }
     return false;
 }
 bool Chunk::has_side_visible(Vector3Int cell_pos) {
+    // look right past each face of the stored cell
+    int size = 1 << this->storage.load()->resolution_shift;
+
     if (Materials::see_through(this->get(cell_pos))) return true;
-    if (Materials::see_through(this->get(cell_pos + Vector3Int(1, 0, 0)))) return true;
+    if (Materials::see_through(this->get(cell_pos + Vector3Int(size, 0, 0)))) return true;
     if (Materials::see_through(this->get(cell_pos + Vector3Int(-1, 0, 0)))) return true;
-    if (Materials::see_through(this->get(cell_pos + Vector3Int(0, 1, 0)))) return true;
+    if (Materials::see_through(this->get(cell_pos + Vector3Int(0, size, 0)))) return true;
     if (Materials::see_through(this->get(cell_pos + Vector3Int(0, -1, 0)))) return true;
-    if (Materials::see_through(this->get(cell_pos + Vector3Int(0, 0, 1)))) return true;
+    if (Materials::see_through(this->get(cell_pos + Vector3Int(0, 0, size)))) return true;
     if (Materials::see_through(this->get(cell_pos + Vector3Int(0, 0, -1)))) return true;
     return false;
 }
 bool Chunk::has_side_visible(Vector3Int cell_pos, unsigned int cell_size) {
-    for (int x = 0; x < cell_size; x++)
-    for (int y = 0; y < cell_size; y++)
-    for (int z = cell_size - 1; z >= 0; z--)
+    int step = 1 << this->storage.load()->resolution_shift;
+    for (int x = 0; x < cell_size; x += step)
+    for (int y = 0; y < cell_size; y += step)
+    for (int z = cell_size - step; z >= 0; z -= step)
     {
         if (this->has_side_visible(cell_pos + Vector3Int(x, y, z))) return true;
     }
@@ -133,6 +144,10 @@ std::vector<GPUCell>* Chunk::flatten(unsigned int lod) {
     if (!this->is_fully_generated()) return nullptr;
 
     if (this->flatten_lod < (int)lod) {
+        #ifndef DISABLE_BUFFER
+        // the staged copy is outdated
+        if (this->world != nullptr) this->world->release_upload(this->upload_region);
+        #endif
         this->flatten_data.clear();
         populate_gpu_data(this->flatten_data, Vector3Int(0, 0, 0), CHUNK_WIDTH, 1<<(CHUNK_RESOLUTION - lod));
         this->flatten_lod = lod;
@@ -142,29 +157,72 @@ std::vector<GPUCell>* Chunk::flatten(unsigned int lod) {
 
 void Chunk::generate(WorldGenerator generator, Vector3Int chunk_pos, unsigned int lod) {
     this->chunk_pos = chunk_pos;
-    this->dispose();
-
-    Vector3Int chunk_world_pos = chunk_pos * CHUNK_WIDTH;
-
-    this->cells = new Cell**[CHUNK_WIDTH];
-    for (int x = 0; x < CHUNK_WIDTH; x++) {
-        this->cells[x] = new Cell*[CHUNK_WIDTH];
-        for (int y = 0; y < CHUNK_WIDTH; y++) {
-            this->cells[x][y] = new Cell[CHUNK_WIDTH];
-            for (int z = 0; z < CHUNK_WIDTH; z++)
-            {
-                this->cells[x][y][z] = { generator.generate_value(chunk_world_pos + Vector3Int(x, y, z)) };
-            }
-        }
-    }
-
     this->flatten_data.clear();
+    #ifndef DISABLE_BUFFER
+    if (this->world != nullptr) this->world->release_upload(this->upload_region);
+    #endif
+
+    // the threads generating the neighbours may still be reading the old cells
+    this->retire(this->storage.exchange(Chunk::generate_storage(generator, chunk_pos, lod)));
+
     populate_gpu_data(this->flatten_data, Vector3Int(0, 0, 0), CHUNK_WIDTH , 1<<(CHUNK_RESOLUTION - lod));
     this->flatten_lod = lod;
     // if (this->flatten_data.size() != 1 && lod == CHUNK_RESOLUTION) std::cout << "nb cells: " << this->flatten_data.size() << "\n";
+    #ifndef DISABLE_BUFFER
+    if (this->world != nullptr) this->upload_region = this->world->stage_upload(this->flatten_data);
+    #endif
 
     this->fully_generated = true;
 }
+CellStorage* Chunk::generate_storage(WorldGenerator& generator, Vector3Int chunk_pos, unsigned int lod) {
+    CellStorage* storage = new CellStorage(CHUNK_RESOLUTION - __min(lod, CHUNK_RESOLUTION));
+    Chunk::generate_cells(generator, chunk_pos * CHUNK_WIDTH, *storage);
+    return storage;
+}
+CellStorage* Chunk::replace_cells(CellStorage* storage) {
+    this->flatten_data.clear();
+    this->flatten_lod = -1;
+    #ifndef DISABLE_BUFFER
+    if (this->world != nullptr) this->world->release_upload(this->upload_region);
+    #endif
+    return this->storage.exchange(storage);
+}
+void Chunk::generate_cells(WorldGenerator& generator, Vector3Int chunk_world_pos, CellStorage& storage) {
+    // the pipeline fills z columns, generated in x / y / z order then moved to their morton index
+    // at a lod each cell is sampled at the center of its (1 << resolution_shift) voxels
+    unsigned int resolution_shift = storage.resolution_shift;
+    unsigned int width = CHUNK_WIDTH >> resolution_shift;
+    std::vector<Cell> generated = std::vector<Cell>(width * width * width);
+    std::vector<Cell*> columns = std::vector<Cell*>(width * width);
+    std::vector<Cell**> rows = std::vector<Cell**>(width);
+    for (unsigned int x = 0; x < width; x++) {
+        rows[x] = &columns[x * width];
+        for (unsigned int y = 0; y < width; y++)
+            rows[x][y] = &generated[(x * width + y) * width];
+    }
+    generator.generate_chunk(rows.data(), chunk_world_pos, width, 1 << resolution_shift);
+
+    // codes of a slice of constant x, the code of a cell is the one of its slice | the one of (0, y, z)
+    int slice_x[CHUNK_WIDTH * CHUNK_WIDTH] = {};
+    int slice_y[CHUNK_WIDTH * CHUNK_WIDTH];
+    int slice_z[CHUNK_WIDTH * CHUNK_WIDTH];
+    uint32_t slice_codes[CHUNK_WIDTH * CHUNK_WIDTH];
+    unsigned int slice_size = width * width;
+    for (unsigned int i = 0; i < slice_size; i++)
+    {
+        slice_y[i] = i / width;
+        slice_z[i] = i % width;
+    }
+    Morton::encode(slice_x, slice_y, slice_z, slice_codes, slice_size);
+
+    for (unsigned int x = 0; x < width; x++)
+    {
+        Cell* slice = &generated[x * slice_size];
+        uint32_t slice_code = Morton::encode(x, 0, 0);
+        for (unsigned int i = 0; i < slice_size; i++)
+            storage.cells[slice_code | slice_codes[i]] = slice[i];
+    }
+}
 #ifndef DISABLE_THREAD
 mingw_stdthread::thread Chunk::generate_threaded(WorldGenerator generator, Vector3Int chunk_pos, unsigned int lod) {
     this->fully_generated = false;
@@ -174,7 +232,8 @@ mingw_stdthread::thread Chunk::generate_threaded(WorldGenerator generator, Vecto
 #endif
 
 Cell* Chunk::operator[](Vector3Int pos) {
-    if (this->cells == nullptr) {
+    CellStorage* storage = this->storage.load();
+    if (storage == nullptr) {
         std::cerr << "accessing undefined chunk cells\n";
         exit(1);
     }
@@ -183,13 +242,16 @@ Cell* Chunk::operator[](Vector3Int pos) {
         exit(1);
     }
     
-    return &(this->cells[pos.x][pos.y][pos.z]);
+    return &(storage->cells[storage->index(pos)]);
 }
 unsigned int Chunk::safe_get(Vector3Int pos, unsigned int default_result) {
     if (!this->is_fully_generated()) return default_result;
     if (!this->in_bounds(pos)) return default_result;
 
-    return this->cells[pos.x][pos.y][pos.z].value;
+    // loaded once: the cells and their resolution come from the same generation
+    CellStorage* storage = this->storage.load();
+    if (storage == nullptr) return default_result;
+    return storage->cells[storage->index(pos)].value;
 }
 unsigned int Chunk::get(Vector3Int pos, unsigned int default_result) {
     if (!this->in_bounds(pos)) {
@@ -197,13 +259,17 @@ unsigned int Chunk::get(Vector3Int pos, unsigned int default_result) {
         return default_result;
     }
 
-    return this->cells[pos.x][pos.y][pos.z].value;
+    CellStorage* storage = this->storage.load();
+    return storage->cells[storage->index(pos)].value;
 }
 bool Chunk::set(Vector3Int pos, unsigned int value) {
     if (!this->is_fully_generated()) return false;
     if (!this->in_bounds(pos)) return false;
+    // a coarse cell covers several voxels, World::set regenerates the chunk at full resolution first
+    CellStorage* storage = this->storage.load();
+    if (storage->resolution_shift != 0) return false;
 
-    this->cells[pos.x][pos.y][pos.z].value = value;
+    storage->cells[storage->index(pos)].value = value;
 
     // reflatten the data
     this->flatten_lod = -1;
@@ -1,5 +1,6 @@
 #ifndef _CHUNK_CLASS
 #define _CHUNK_CLASS
+// at most 5: the shader keeps node offsets of a chunk on 16 bits (test.frag TreeCursor)
 #define CHUNK_RESOLUTION 5
 #define CHUNK_WIDTH (1<<CHUNK_RESOLUTION)
 
@@ -10,6 +11,7 @@
 #include <atomic>
 
 #include <vector>
+#include <algorithm>
 
 #include "./materials.h"
 #include "./world_generator.h"
@@ -17,6 +19,10 @@
 class WorldGenerator;
 
 #include "../utility/math/vector3.h"
+#include "../utility/math/morton.h"
+#ifndef DISABLE_BUFFER
+    #include "../utility/graphics/upload_ring.h"
+#endif
 
 #define CELL_MEMORY_SIZE (sizeof(unsigned int) * 9)
 struct Cell{
@@ -24,20 +30,33 @@ struct Cell{
 };
 struct GPUCell{
     unsigned int value = MATERIAL_AIR;
-    unsigned int cell_000 = 0;
-    unsigned int cell_001 = 0;
-    unsigned int cell_010 = 0;
-    unsigned int cell_011 = 0;
-    unsigned int cell_100 = 0;
-    unsigned int cell_101 = 0;
-    unsigned int cell_110 = 0;
-    unsigned int cell_111 = 0;
+    // index of each child in the chunk data, 0 if it has the value of this cell
+    unsigned int children[8] = {};
 
-    // (x, y, z) -> ²xyz
+    // morton child code (see morton.h): (x, y, z) -> ²xyz
     // (0, 1, 0) -> ²010 = 2
     unsigned int& operator[](int code);
 };
 
+// the cells of a chunk with their resolution, swapped as one pointer
+// so a reader never pairs the cells of one generation with the resolution of another
+struct CellStorage
+{
+    // (CHUNK_WIDTH >> resolution_shift)^3 cells in morton order (see morton.h)
+    // every node of the octree is a contiguous range of them
+    Cell* cells = nullptr;
+    // cells are (1 << resolution_shift) voxels wide, chunks far away are generated at their lod resolution
+    unsigned int resolution_shift = 0;
+
+    CellStorage(unsigned int resolution_shift);
+    CellStorage(const CellStorage&) = delete;
+    CellStorage & operator=(const CellStorage&) = delete;
+    ~CellStorage();
+
+    // index in cells of the cell holding this voxel
+    uint32_t index(Vector3Int pos);
+};
+
 class World;
 class Chunk
 {
@@ -45,21 +64,30 @@ private:
     std::vector<GPUCell> flatten_data;
     int flatten_lod = -1;
     std::atomic_bool fully_generated = {false};
+    // read without lock by the threads generating the neighbours (World::get)
+    // a replaced storage is retired to the world, freed once no generation runs
+    std::atomic<CellStorage*> storage = {nullptr};
 
     Cell* operator[](Vector3Int pos);
+    // give a replaced storage to the world, or free it without one
+    void retire(CellStorage* storage);
     
     bool has_subcells(Vector3Int cell_pos, unsigned int cell_size);
     bool has_side_visible(Vector3Int cell_pos);
     bool has_side_visible(Vector3Int cell_pos, unsigned int cell_size);
+
+    // fill the cells of storage for the chunk starting at chunk_world_pos
+    static void generate_cells(WorldGenerator& generator, Vector3Int chunk_world_pos, CellStorage& storage);
 public:
     #ifndef DISABLE_BUFFER
     unsigned int last_GPU_size = 0;
     unsigned int GPU_index = 0;
+    // flatten data written to the world upload ring by the thread that generated the chunk
+    UploadRegion upload_region;
     #endif
 
     World* world;
     Vector3Int chunk_pos;
-    Cell*** cells = nullptr;
     Chunk();
     Chunk & operator=(const Chunk&) = delete;
     Chunk(const Chunk&) = delete;
@@ -67,8 +95,17 @@ public:
     bool in_bounds(Vector3Int position);
 
     bool is_fully_generated();
+    // lod the cells were generated at (CHUNK_RESOLUTION for full resolution)
+    unsigned int get_resolution();
+    // nullptr until the chunk is generated
+    CellStorage* get_storage();
     
     void generate(WorldGenerator generator, Vector3Int chunk_pos, unsigned int lod);
+    // cells of the chunk at chunk_pos at this lod, without touching any chunk (any thread)
+    static CellStorage* generate_storage(WorldGenerator& generator, Vector3Int chunk_pos, unsigned int lod);
+    // swap in cells from generate_storage, the flatten data is computed again by the next flatten
+    // returns the old storage, for World::retire_cells once the caller releases its locks
+    CellStorage* replace_cells(CellStorage* storage);
     #ifndef DISABLE_THREAD
     mingw_stdthread::thread generate_threaded(WorldGenerator generator, Vector3Int chunk_pos, unsigned int lod);
     #endif
@@ -0,0 +1,137 @@
+#ifndef _GENERATOR_PIPELINE
+
+#include "./generator_pipeline.h"
+
+#pragma region context
+GenerationContext::GenerationContext(Cell*** cells, Vector3Int origin, unsigned int width, unsigned int step) {
+    this->cells = cells;
+    this->origin = origin;
+    this->width = width;
+    this->step = step;
+}
+
+void StageTimings::add(unsigned int stage, const char* name, double seconds) {
+    if (stage >= this->names.size()) {
+        this->names.resize(stage + 1);
+        this->seconds.resize(stage + 1, 0);
+    }
+    this->names[stage] = name;
+    this->seconds[stage] += seconds;
+}
+void StageTimings::print() {
+    double total = 0;
+    for (double stage_seconds : this->seconds) total += stage_seconds;
+
+    for (int i = 0; i < this->names.size(); i++)
+    {
+        std::cout << "    " << this->names[i] << ": "
+            << this->seconds[i] * 1000000 / __max(1U, this->chunks) << " us/chunk ("
+            << (total > 0 ? this->seconds[i] * 100 / total : 0) << "%)\n";
+    }
+}
+#pragma endregion
+
+#pragma region stages
+HeightmapStage::HeightmapStage(WorldGenerator& generator) {
+    this->generator = &generator;
+}
+void HeightmapStage::prepare(GenerationContext& context) {
+    this->generator->generate_heightmap(context.heightmap, context.origin, context.width, context.step);
+}
+
+CaveStage::CaveStage(WorldGenerator& generator) {
+    this->noise = generator.cave_noise;
+    this->spacing = generator.density_lattice;
+}
+CaveStage::CaveStage(Noise noise, unsigned int spacing) {
+    this->noise = noise;
+    this->spacing = spacing;
+}
+void CaveStage::prepare(GenerationContext& context) {
+    int width = context.width;
+    this->xs.resize(width);
+    this->ys.resize(width);
+    this->zs.resize(width);
+    this->density.resize(width);
+    for (int z = 0; z < width; z++) this->zs[z] = context.origin.z + context.sample_offset(z);
+
+    if (this->spacing == 0) return;
+    int spacing = this->spacing;
+
+    // lattice points are aligned on multiples of spacing in world space, like in WorldGenerator::cave_density
+    Vector3Int lattice_origin = Vector3Int(
+        (int)floorf((float)context.origin.x / spacing) * spacing,
+        (int)floorf((float)context.origin.y / spacing) * spacing,
+        (int)floorf((float)context.origin.z / spacing) * spacing);
+    this->offset = context.origin - lattice_origin;
+    int last = context.sample_offset(width - 1);
+    int size_x = (this->offset.x + last) / spacing + 2;
+    this->size_y = (this->offset.y + last) / spacing + 2;
+    this->size_z = (this->offset.z + last) / spacing + 2;
+
+    // no need for lattice levels above the highest solid voxel
+    int solid_top = (int)floorf(context.heightmap.max_height) - lattice_origin.z;
+    if (solid_top < 0) {
+        this->size_z = 0;
+        return;
+    }
+    this->size_z = __min(this->size_z, solid_top / spacing + 2);
+    if (this->size_z > width) this->density.resize(this->size_z);
+
+    // one column of lattice points per batch
+    this->lattice.resize(size_x * this->size_y * this->size_z);
+    std::vector<float> xs = std::vector<float>(this->size_z);
+    std::vector<float> ys = std::vector<float>(this->size_z);
+    std::vector<float> zs = std::vector<float>(this->size_z);
+    for (int z = 0; z < this->size_z; z++) zs[z] = lattice_origin.z + z * spacing;
+    for (int x = 0; x < size_x; x++)
+    for (int y = 0; y < this->size_y; y++)
+    {
+        std::fill(xs.begin(), xs.end(), (float)(lattice_origin.x + x * spacing));
+        std::fill(ys.begin(), ys.end(), (float)(lattice_origin.y + y * spacing));
+        this->noise.sample(&xs[0], &ys[0], &zs[0], &this->lattice[(x * this->size_y + y) * this->size_z], this->size_z);
+    }
+}
+
+WaterStage::WaterStage(int level) {
+    this->level = level;
+}
+
+SeabedDecorator::SeabedDecorator(int level) {
+    this->level = level;
+}
+#pragma endregion
+
+#pragma region RuntimePipeline
+bool RuntimePipeline::remove_stage(std::string name) {
+    unsigned int old_size = this->stages.size();
+    this->stages.erase(
+        std::remove_if(this->stages.begin(), this->stages.end(), [&](std::unique_ptr<GeneratorStage>& stage) { return name == stage->get_name(); }),
+        this->stages.end());
+    return this->stages.size() != old_size;
+}
+void RuntimePipeline::clear() {
+    this->stages.clear();
+}
+unsigned int RuntimePipeline::get_stage_count() {
+    return this->stages.size();
+}
+
+void RuntimePipeline::generate(GenerationContext& context) {
+    for (auto& stage : this->stages) stage->prepare(context);
+    for (auto& stage : this->stages) stage->columns(context);
+}
+void RuntimePipeline::generate_timed(GenerationContext& context, StageTimings& timings) {
+    for (int i = 0; i < this->stages.size(); i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        this->stages[i]->prepare(context);
+        this->stages[i]->columns(context);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        timings.add(i, this->stages[i]->get_name(), elapsed.count());
+    }
+    timings.chunks++;
+}
+#pragma endregion
+
+#endif
\ No newline at end of file
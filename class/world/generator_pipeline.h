@@ -0,0 +1,346 @@
+#ifndef _GENERATOR_PIPELINE
+#define _GENERATOR_PIPELINE
+
+#include <vector>
+#include <tuple>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+
+#include "./materials.h"
+#include "./world_generator.h"
+#include "./chunk.h"
+#include "../utility/math/noise.h"
+
+// a stage is any class with:
+//     static const char* name();
+//     void prepare(GenerationContext& context);                         once per chunk, before any column
+//     void column(GenerationContext& context, int x, int y, Cell* column); once per column, column[z] for z in [0, width)
+// column must only depend on its own column and on what prepare computed
+// so stages can run fused (every stage on a column) or one after the other
+// sample i of an axis is the voxel at origin + context.sample_offset(i): every voxel, or the center of each
+// cube of step voxels for the chunks generated at a lod
+
+#pragma region context
+// division rounded toward -infinity
+inline int floor_div(int a, int b) {
+    return (a >= 0 ? a : a - b + 1) / b;
+}
+
+// shared by the stages while generating one chunk
+struct GenerationContext
+{
+    Cell*** cells = nullptr;
+    Vector3Int origin;
+    // samples along each axis
+    unsigned int width = 0;
+    // voxels between two samples
+    int step = 1;
+    Heightmap heightmap;
+
+    GenerationContext(Cell*** cells, Vector3Int origin, unsigned int width, unsigned int step = 1);
+
+    // distance from the origin of the sample i along an axis
+    int sample_offset(int i) {
+        return this->step / 2 + i * this->step;
+    }
+    // samples at the bottom of the column at or under the height z
+    int count_to(int z) {
+        int count = floor_div(z - this->origin.z - this->step / 2, this->step) + 1;
+        return __max(0, __min((int)this->width, count));
+    }
+    // samples at the bottom of the column that are at or under its ground level
+    int solid_count(int x, int y) {
+        return this->count_to((int)floorf(this->heightmap.get(x, y)));
+    }
+    // samples at the bottom of the column at or under ground level - depth
+    int count_under(int x, int y, float depth) {
+        return this->count_to((int)floorf(this->heightmap.get(x, y) - depth));
+    }
+};
+
+// time spent in each stage, accumulated over several chunks
+struct StageTimings
+{
+    std::vector<std::string> names;
+    std::vector<double> seconds;
+    unsigned int chunks = 0;
+
+    void add(unsigned int stage, const char* name, double seconds);
+    void print();
+};
+
+inline float density_lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+#pragma endregion
+
+#pragma region stages
+// ground level of every column, from WorldGenerator::generate_heightmap
+class HeightmapStage
+{
+private:
+    WorldGenerator* generator;
+public:
+    HeightmapStage(WorldGenerator& generator);
+    static const char* name() { return "heightmap"; }
+
+    void prepare(GenerationContext& context);
+    void column(GenerationContext& context, int x, int y, Cell* column) {}
+};
+
+// grass, then dirt, then stone under the ground level
+class StrataStage
+{
+public:
+    static const char* name() { return "strata"; }
+
+    void prepare(GenerationContext& context) {}
+    void column(GenerationContext& context, int x, int y, Cell* column) {
+        int stone_count = context.count_under(x, y, DIRT_DEPTH);
+        int dirt_count = context.count_under(x, y, GRASS_DEPTH);
+        int grass_count = context.solid_count(x, y);
+
+        std::fill(column, column + stone_count, Cell{ MATERIAL_STONE });
+        std::fill(column + stone_count, column + dirt_count, Cell{ MATERIAL_DIRT });
+        std::fill(column + dirt_count, column + grass_count, Cell{ MATERIAL_GRASS });
+    }
+};
+
+// carve caves in solid voxels where |noise| < CAVE_THRESHOLD
+// with a lattice spacing the noise is sampled every spacing voxels and trilinearly interpolated
+class CaveStage
+{
+private:
+    Noise noise;
+    int spacing = 0;
+
+    std::vector<float> xs, ys, zs, density;
+
+    // lattice mode
+    std::vector<float> lattice;
+    Vector3Int offset;
+    int size_y = 0;
+    int size_z = 0;
+
+    void column_exact(GenerationContext& context, int x, int y, Cell* column, int solid_count);
+    void column_lattice(GenerationContext& context, int x, int y, Cell* column, int solid_count);
+public:
+    CaveStage(WorldGenerator& generator);
+    CaveStage(Noise noise, unsigned int spacing = 0);
+    static const char* name() { return "caves"; }
+
+    void prepare(GenerationContext& context);
+    void column(GenerationContext& context, int x, int y, Cell* column) {
+        int solid_count = context.solid_count(x, y);
+        if (solid_count == 0) return;
+
+        if (this->spacing == 0) this->column_exact(context, x, y, column, solid_count);
+        else this->column_lattice(context, x, y, column, solid_count);
+    }
+};
+
+// water above the ground level, up to level
+class WaterStage
+{
+private:
+    int level;
+public:
+    WaterStage(int level = WATER_LEVEL);
+    static const char* name() { return "water"; }
+
+    void prepare(GenerationContext& context) {}
+    void column(GenerationContext& context, int x, int y, Cell* column) {
+        int water_count = context.count_to(this->level - 1);
+        for (int z = context.solid_count(x, y); z < water_count; z++)
+        {
+            if (column[z].value == MATERIAL_AIR) column[z].value = MATERIAL_WATER;
+        }
+    }
+};
+
+// decorator: no grass under water, the seabed is dirt
+class SeabedDecorator
+{
+private:
+    int level;
+public:
+    SeabedDecorator(int level = WATER_LEVEL);
+    static const char* name() { return "seabed"; }
+
+    void prepare(GenerationContext& context) {}
+    void column(GenerationContext& context, int x, int y, Cell* column) {
+        int underwater_count = context.count_to(this->level - 1);
+        for (int z = 0; z < underwater_count; z++)
+        {
+            if (column[z].value == MATERIAL_GRASS) column[z].value = MATERIAL_DIRT;
+        }
+    }
+};
+
+// cave inline methods, in the header so the fused column loop can inline them
+inline void CaveStage::column_exact(GenerationContext& context, int x, int y, Cell* column, int solid_count) {
+    std::fill(this->xs.begin(), this->xs.begin() + solid_count, (float)(context.origin.x + context.sample_offset(x)));
+    std::fill(this->ys.begin(), this->ys.begin() + solid_count, (float)(context.origin.y + context.sample_offset(y)));
+    this->noise.sample(&this->xs[0], &this->ys[0], &this->zs[0], &this->density[0], solid_count);
+
+    for (int z = 0; z < solid_count; z++)
+    {
+        if (fabsf(this->density[z]) - CAVE_THRESHOLD < 0) column[z].value = MATERIAL_AIR;
+    }
+}
+inline void CaveStage::column_lattice(GenerationContext& context, int x, int y, Cell* column, int solid_count) {
+    // interpolate in x and y once per lattice level of the column, then in z per voxel
+    // same operations as WorldGenerator::cave_density
+    int spacing = this->spacing;
+    int local_x = this->offset.x + context.sample_offset(x);
+    int local_y = this->offset.y + context.sample_offset(y);
+    int lattice_x = local_x / spacing;
+    int lattice_y = local_y / spacing;
+    float fx = (float)(local_x % spacing) / spacing;
+    float fy = (float)(local_y % spacing) / spacing;
+    float* corner00 = &this->lattice[(lattice_x * this->size_y + lattice_y) * this->size_z];
+    float* corner10 = &this->lattice[((lattice_x + 1) * this->size_y + lattice_y) * this->size_z];
+    float* corner01 = &this->lattice[(lattice_x * this->size_y + lattice_y + 1) * this->size_z];
+    float* corner11 = &this->lattice[((lattice_x + 1) * this->size_y + lattice_y + 1) * this->size_z];
+
+    float* levels = &this->density[0];
+    int level_count = (this->offset.z + context.sample_offset(solid_count - 1)) / spacing + 2;
+    for (int z = 0; z < level_count; z++)
+    {
+        levels[z] = density_lerp(density_lerp(corner00[z], corner10[z], fx), density_lerp(corner01[z], corner11[z], fx), fy);
+    }
+
+    for (int z = 0; z < solid_count; z++)
+    {
+        int local_z = this->offset.z + context.sample_offset(z);
+        int lattice_z = local_z / spacing;
+        float fz = (float)(local_z % spacing) / spacing;
+        if (fabsf(density_lerp(levels[lattice_z], levels[lattice_z + 1], fz)) - CAVE_THRESHOLD < 0) column[z].value = MATERIAL_AIR;
+    }
+}
+#pragma endregion
+
+#pragma region GeneratorPipeline
+// stages composed at compile time: every call is known so the column loop is inlined into one loop per chunk
+template <typename... Stages>
+class GeneratorPipeline
+{
+private:
+    std::tuple<Stages...> stages;
+
+    template <std::size_t... I>
+    void prepare_all(GenerationContext& context, std::index_sequence<I...>) {
+        int expand[] = { 0, (std::get<I>(this->stages).prepare(context), 0)... };
+        (void)expand;
+    }
+    template <std::size_t... I>
+    void column_all(GenerationContext& context, int x, int y, Cell* column, std::index_sequence<I...>) {
+        int expand[] = { 0, (std::get<I>(this->stages).column(context, x, y, column), 0)... };
+        (void)expand;
+    }
+    template <typename Stage>
+    double run_stage(GenerationContext& context, Stage& stage) {
+        auto start = std::chrono::steady_clock::now();
+        stage.prepare(context);
+        auto prepared = std::chrono::steady_clock::now();
+        for (unsigned int x = 0; x < context.width; x++)
+        for (unsigned int y = 0; y < context.width; y++)
+        {
+            stage.column(context, x, y, context.cells[x][y]);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - prepared;
+        std::chrono::duration<double> prepare_time = prepared - start;
+        return elapsed.count() + prepare_time.count();
+    }
+    template <std::size_t... I>
+    void run_timed(GenerationContext& context, StageTimings& timings, std::index_sequence<I...>) {
+        int expand[] = { 0, (timings.add(I, std::tuple_element<I, std::tuple<Stages...>>::type::name(), this->run_stage(context, std::get<I>(this->stages))), 0)... };
+        (void)expand;
+    }
+public:
+    GeneratorPipeline(Stages... stages) : stages(stages...) {}
+
+    // prepare every stage, then run every stage on each column
+    void generate(GenerationContext& context) {
+        this->prepare_all(context, std::index_sequence_for<Stages...>());
+        for (unsigned int x = 0; x < context.width; x++)
+        for (unsigned int y = 0; y < context.width; y++)
+        {
+            this->column_all(context, x, y, context.cells[x][y], std::index_sequence_for<Stages...>());
+        }
+    }
+    // same cells as generate, running the stages one after the other to time them
+    void generate_timed(GenerationContext& context, StageTimings& timings) {
+        this->run_timed(context, timings, std::index_sequence_for<Stages...>());
+        timings.chunks++;
+    }
+};
+
+template <typename... Stages>
+GeneratorPipeline<Stages...> make_pipeline(Stages... stages) {
+    return GeneratorPipeline<Stages...>(stages...);
+}
+#pragma endregion
+
+#pragma region RuntimePipeline
+// type erased stage for RuntimePipeline
+class GeneratorStage
+{
+public:
+    virtual ~GeneratorStage() {}
+    virtual const char* get_name() = 0;
+    virtual void prepare(GenerationContext& context) = 0;
+    // every column of the chunk, one virtual call per stage and chunk
+    virtual void columns(GenerationContext& context) = 0;
+};
+
+template <typename Stage>
+class DynamicStage : public GeneratorStage
+{
+private:
+    Stage stage;
+public:
+    DynamicStage(Stage stage) : stage(stage) {}
+
+    const char* get_name() { return Stage::name(); }
+    void prepare(GenerationContext& context) { this->stage.prepare(context); }
+    void columns(GenerationContext& context) {
+        for (unsigned int x = 0; x < context.width; x++)
+        for (unsigned int y = 0; y < context.width; y++)
+        {
+            this->stage.column(context, x, y, context.cells[x][y]);
+        }
+    }
+};
+
+// stages added, removed and reordered at runtime, to prototype before fixing a GeneratorPipeline
+// runs the stages one after the other instead of fused
+class RuntimePipeline
+{
+private:
+    std::vector<std::unique_ptr<GeneratorStage>> stages;
+public:
+    template <typename Stage>
+    void add_stage(Stage stage) {
+        this->stages.push_back(std::unique_ptr<GeneratorStage>(new DynamicStage<Stage>(stage)));
+    }
+    // insert the stage before the one at index
+    template <typename Stage>
+    void insert_stage(unsigned int index, Stage stage) {
+        index = __min(index, (unsigned int)this->stages.size());
+        this->stages.insert(this->stages.begin() + index, std::unique_ptr<GeneratorStage>(new DynamicStage<Stage>(stage)));
+    }
+    // remove every stage with this name, returns false if there was none
+    bool remove_stage(std::string name);
+    void clear();
+    unsigned int get_stage_count();
+
+    void generate(GenerationContext& context);
+    void generate_timed(GenerationContext& context, StageTimings& timings);
+};
+#pragma endregion
+
+#endif
@@ -1,29 +1,27 @@
 #ifndef _MATERIALS
 #include "./materials.h"
 
-bool Materials::see_through(unsigned int material_id) {
-    switch (material_id)
+std::vector<GPUMaterial> Materials::get_gpu_table() {
+    std::vector<GPUMaterial> table = std::vector<GPUMaterial>(MATERIAL_COUNT + 1);
+    for (unsigned int i = 0; i <= MATERIAL_COUNT; i++)
     {
-    case MATERIAL_AIR:
-        return true;
-    case MATERIAL_WATER:
-        return true;
-    
-    default:
-        return false;
-    }
-}
-bool Materials::is_solid(unsigned int material_id) {
-    switch (material_id)
-    {
-    case MATERIAL_AIR:
-        return false;
-    case MATERIAL_WATER:
-        return false;
-    
-    default:
-        return true;
+        const MaterialInfo& info = Materials::registry[i];
+        GPUMaterial& material = table[i];
+        for (int c = 0; c < 3; c++)
+        {
+            material.color[c] = info.color[c];
+            material.emission_color[c] = info.emission_color[c];
+            material.volume_color[c] = info.volume_color[c];
+        }
+        material.reflection = info.reflection;
+        material.emission_strength = info.emission_strength;
+        material.volume = info.volume;
+        material.ior = info.ior;
+        material.transparency = info.transparency;
+        material.flags = info.flags;
+        material.padding = 0;
     }
+    return table;
 }
 
 #endif
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef _MATERIALS
 #define _MATERIALS
 
+#include <vector>
+#include <cstdint>
+
 #define MATERIAL_AIR        0U
 #define MATERIAL_GRASS      1U
 #define MATERIAL_DIRT       2U
@@ -8,10 +11,99 @@
 #define MATERIAL_WATER      4U
 #define MATERIAL_BUILDING   5U
 #define MATERIAL_LIGHT      6U
+// materials in the registry, injected in the shader
+#define MATERIAL_COUNT      7U
+
+// what the engine needs to know about a material, same bits in materials.glsl
+#define MATERIAL_SEE_THROUGH    (1U << 0)   // faces behind it are visible
+#define MATERIAL_SOLID          (1U << 1)   // stops raycasts
+#define MATERIAL_WAVES          (1U << 2)   // animated surface in the shader
+
+// one line of the registry, the id of a material is its index
+struct MaterialInfo
+{
+    const char* name;
+    unsigned int flags;
+    float color[3];
+    float reflection;
+    float ior;
+    float transparency;
+    float emission_color[3];
+    float emission_strength;
+    float volume_color[3];
+    float volume;
+};
+
+// std430 layout of Material in materials.glsl
+struct GPUMaterial
+{
+    float color[3];
+    float reflection;
+    float emission_color[3];
+    float emission_strength;
+    float volume_color[3];
+    float volume;
+    float ior;
+    float transparency;
+    unsigned int flags;
+    unsigned int padding;
+};
 
 namespace Materials {
-    bool see_through(unsigned int material_id);
-    bool is_solid(unsigned int material_id);
+    // adding a material is adding a line here (and its id above), the shader reads the table as it is
+    constexpr MaterialInfo registry[MATERIAL_COUNT + 1] = {
+        //  name        flags                                   color               reflection  IOR     transparency    emission         emission_strength  volume_color      volume
+        { "air",        MATERIAL_SEE_THROUGH,                   { 0, 0, 0 },        0,          1,      1,              { 0, 0, 0 },     0,                 { .5f, 1, 1 },    .005f },
+        { "grass",      MATERIAL_SOLID,                         { 0, .75f, 0 },     0,          1,      0,              { 0, 0, 0 },     0,                 { 0, 0, 0 },      0 },
+        { "dirt",       MATERIAL_SOLID,                         { .4f, .2f, .1f },  0,          1,      0,              { 0, 0, 0 },     0,                 { 0, 0, 0 },      0 },
+        { "stone",      MATERIAL_SOLID,                         { .25f, .25f, .25f }, 0,        1,      0,              { 0, 0, 0 },     0,                 { 0, 0, 0 },      0 },
+        { "water",      MATERIAL_SEE_THROUGH | MATERIAL_WAVES,  { .75f, 1, 1 },     .75f,       1.333f, .75f,           { 0, 0, 0 },     0,                 { 0, .75f, .5f }, .15f },
+        { "building",   MATERIAL_SOLID,                         { 1, .3f, 0 },      0,          1,      0,              { 0, 0, 0 },     0,                 { 0, 0, 0 },      0 },
+        { "light",      MATERIAL_SOLID,                         { .9f, .9f, 1 },    .8f,        1,      0,              { .9f, .9f, 1 }, 0,                 { 0, 0, 0 },      0 },
+        // any other id: solid and magenta
+        { "unknown",    MATERIAL_SOLID,                         { 1, 0, 1 },        0,          1,      0,              { 1, 0, 1 },     1,                 { 0, 0, 0 },      0 },
+    };
+
+    // materials of the registry with this flag
+    constexpr unsigned int count_with(unsigned int flag) {
+        unsigned int count = 0;
+        for (unsigned int i = 0; i <= MATERIAL_COUNT; i++) count += (registry[i].flags & flag) != 0;
+        return count;
+    }
+
+    // material_id is one of the ids whose flag is VALUE (the unknown material is every id from MATERIAL_COUNT)
+    // one comparison per id known at compile time, the ids without it are dropped
+    template <unsigned int FLAG, bool VALUE, unsigned int ID = 0>
+    struct FlagIds
+    {
+        static inline bool contains(unsigned int material_id) {
+            return (((registry[ID].flags & FLAG) != 0) == VALUE && material_id == ID) | FlagIds<FLAG, VALUE, ID + 1>::contains(material_id);
+        }
+    };
+    template <unsigned int FLAG, bool VALUE>
+    struct FlagIds<FLAG, VALUE, MATERIAL_COUNT>
+    {
+        static inline bool contains(unsigned int material_id) {
+            return ((registry[MATERIAL_COUNT].flags & FLAG) != 0) == VALUE && material_id >= MATERIAL_COUNT;
+        }
+    };
+
+    // the comparisons of a switch generated from the registry, against the shorter list of ids (with or without the flag)
+    // no branch and no load, vectorized by the compiler in the hot loops (visibility, raycasts)
+    template <unsigned int FLAG>
+    inline bool has_flag(unsigned int material_id) {
+        if (count_with(FLAG) * 2 <= MATERIAL_COUNT + 1) return FlagIds<FLAG, true>::contains(material_id);
+        return !FlagIds<FLAG, false>::contains(material_id);
+    }
+    inline bool see_through(unsigned int material_id) {
+        return has_flag<MATERIAL_SEE_THROUGH>(material_id);
+    }
+    inline bool is_solid(unsigned int material_id) {
+        return has_flag<MATERIAL_SOLID>(material_id);
+    }
+
+    // what the shader indexes, one entry per id then the unknown material
+    std::vector<GPUMaterial> get_gpu_table();
 }
 
 #endif
\ No newline at end of file
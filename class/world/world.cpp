@@ -41,6 +41,7 @@ World::World(unsigned int loading_radius, WorldGenerator* generator) {
 
     #ifndef DISABLE_THREAD
     this->task_queue = std::queue<GenerationTask>();
+    this->upload_lock = new mingw_stdthread::mutex();
     #endif
     this->last_radius_loaded = -1;
 }
@@ -87,6 +88,12 @@ void World::load_circle(int radius) {
 void World::update(float max_time) {
     #ifndef DISABLE_THREAD
     if (this->task_queue.empty()) {
+        {
+            // no generation thread is left to read the retired cells
+            std::lock_guard<mingw_stdthread::mutex> guard(*this->upload_lock);
+            for (CellStorage* storage : this->retired_cells) delete storage;
+            this->retired_cells.clear();
+        }
     #endif
         if (this->last_radius_loaded < (int)(this->loading_radius)) {
             this->load_circle(this->last_radius_loaded + 1);
@@ -104,11 +111,49 @@ void World::update(float max_time) {
             }
         }
 
-        this->send_data(this->task_queue.front().chunk_pos);
+        this->queue_upload(this->task_queue.front().chunk_pos);
         this->task_queue.pop();
     }
     #endif
 }
+void World::queue_upload(Vector3Int chunk_pos) {
+    #ifndef DISABLE_BUFFER
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(*this->upload_lock);
+    #endif
+    // flattened here so the render thread only copies
+    this->get_chunk(chunk_pos)->flatten(this->compute_lod(chunk_pos));
+    for (Vector3Int& pending : this->pending_uploads)
+        if (pending == chunk_pos) return;
+    this->pending_uploads.push_back(chunk_pos);
+    #endif
+}
+void World::upload_pending() {
+    #ifndef DISABLE_BUFFER
+    if (this->upload_ring != nullptr) this->upload_ring->next_frame();
+
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(*this->upload_lock);
+    #endif
+    for (Vector3Int& chunk_pos : this->pending_uploads)
+        this->send_data(chunk_pos);
+    this->pending_uploads.clear();
+    #endif
+}
+void World::retire_cells(CellStorage* storage) {
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(*this->upload_lock);
+    this->retired_cells.push_back(storage);
+    #else
+    delete storage;
+    #endif
+}
+bool World::is_loaded() {
+    #ifndef DISABLE_THREAD
+    if (!this->task_queue.empty()) return false;
+    #endif
+    return this->last_radius_loaded >= (int)(this->loading_radius);
+}
 
 void World::dispose() {
     #ifndef DISABLE_THREAD
@@ -118,6 +163,9 @@ void World::dispose() {
         this->task_queue.pop();
     }
     #endif
+    this->pending_uploads.clear();
+    for (CellStorage* storage : this->retired_cells) delete storage;
+    this->retired_cells.clear();
 
     if (this->chunks != nullptr) {
         for (int x = 0; x < this->loading_radius * 2 + 1; x++) {
@@ -137,20 +185,49 @@ void World::dispose() {
 
     if (this->data_buffer.is_buffer()) this->data_buffer.dispose();
     if (this->index_buffer.is_buffer()) this->index_buffer.dispose();
+    if (this->upload_ring != nullptr) {
+        this->upload_ring->dispose();
+        delete this->upload_ring;
+        this->upload_ring = nullptr;
+    }
+    #endif
+    #ifndef DISABLE_THREAD
+    if (this->upload_lock != nullptr) {
+        delete this->upload_lock;
+        this->upload_lock = nullptr;
+    }
     #endif
 }
 #ifndef DISABLE_BUFFER
-void World::create_buffer(GLuint data_buffer_binding, GLuint index_buffer_binding) {
-    this->data_buffer = GrowableBuffer(true, CELL_MEMORY_SIZE * 2000 * 10 * 10);
+void World::create_buffer(GLuint data_buffer_binding, GLuint index_buffer_binding, BufferDevice* device) {
+    this->data_buffer = GrowableBuffer(true, CELL_MEMORY_SIZE * 2000 * 10 * 10, 0, device);
     this->data_buffer.bind_buffer(data_buffer_binding);
-    this->index_buffer = Buffer(true);
+    this->index_buffer = Buffer(true, device);
     this->index_buffer.bind_buffer(index_buffer_binding);
     this->index_buffer.set_data((__pow3(this->loading_radius*2+1) + 2) * sizeof(unsigned int), this->GPU_root_indexes);
+    this->upload_ring = new UploadRing(true, UPLOAD_SEGMENT_SIZE, UPLOAD_RING_SEGMENTS, device);
+}
+UploadRegion World::stage_upload(std::vector<GPUCell>& data) {
+    if (this->upload_ring == nullptr || data.empty()) return UploadRegion();
+
+    UploadRegion region = this->upload_ring->allocate(data.size() * CELL_MEMORY_SIZE);
+    if (region.is_valid()) memcpy(region.data, &data[0], region.size);
+    return region;
+}
+void World::release_upload(UploadRegion& region) {
+    if (this->upload_ring != nullptr) this->upload_ring->release(region);
+}
+float World::get_upload_stall_time() {
+    if (this->upload_ring == nullptr) return 0;
+    return this->upload_ring->get_stall_time();
 }
 #endif
 void World::send_data() {
     #ifndef DISABLE_BUFFER
     if (!this->data_buffer.is_buffer() || !this->index_buffer.is_buffer()) return;
+    #ifndef DISABLE_THREAD
+    std::lock_guard<mingw_stdthread::mutex> guard(*this->upload_lock);
+    #endif
 
     for (int x = -(int)(this->loading_radius); x <= (int)(this->loading_radius); x++)
     for (int y = -(int)(this->loading_radius); y <= (int)(this->loading_radius); y++)
@@ -175,7 +252,11 @@ void World::send_data(Vector3Int chunk_pos_modified) {
     if (chunk_data != nullptr) new_size = chunk_data->size();
     chunk->last_GPU_size = new_size;
 
+    // written by the generation thread, copied gpu side
+    UploadRegion& region = chunk->upload_region;
+
     if (new_size == 0) {
+        this->release_upload(region);
         if (old_size == 0) return;
 
         // erase old data
@@ -195,16 +276,25 @@ void World::send_data(Vector3Int chunk_pos_modified) {
     }
     else {
         if (old_size == 0) {
-            this->GPU_root_indexes[chunk->GPU_index] = data_buffer.push_data(new_size * CELL_MEMORY_SIZE, &((*chunk_data)[0])) / CELL_MEMORY_SIZE + GPU_CELL_UNUSED_OFFSET;
+            unsigned int push_offset = data_buffer.get_used_size();
+            if (region.is_valid() && data_buffer.copy_data(push_offset, *this->upload_ring, region))
+                this->GPU_root_indexes[chunk->GPU_index] = push_offset / CELL_MEMORY_SIZE + GPU_CELL_UNUSED_OFFSET;
+            else
+                this->GPU_root_indexes[chunk->GPU_index] = data_buffer.push_data(new_size * CELL_MEMORY_SIZE, &((*chunk_data)[0])) / CELL_MEMORY_SIZE + GPU_CELL_UNUSED_OFFSET;
+            this->release_upload(region);
             index_buffer.set_data((FIRST_CHUNK_INDEX + __pow3(this->loading_radius * 2 + 1)) * sizeof(unsigned int), this->GPU_root_indexes);
             return;
         }
         else {
-            data_buffer.replace_data(
-                offset * CELL_MEMORY_SIZE,
-                old_size * CELL_MEMORY_SIZE,
-                new_size * CELL_MEMORY_SIZE,
-                &((*chunk_data)[0]));
+            if (region.is_valid())
+                data_buffer.replace_data(offset * CELL_MEMORY_SIZE, old_size * CELL_MEMORY_SIZE, *this->upload_ring, region);
+            else
+                data_buffer.replace_data(
+                    offset * CELL_MEMORY_SIZE,
+                    old_size * CELL_MEMORY_SIZE,
+                    new_size * CELL_MEMORY_SIZE,
+                    &((*chunk_data)[0]));
+            if (new_size == old_size) return;
         
             for (int i = FIRST_CHUNK_INDEX; i < FIRST_CHUNK_INDEX + __pow3(this->loading_radius * 2 + 1); i++)
             {
@@ -246,8 +336,28 @@ void World::set(Vector3Int pos, unsigned int value) {
     
     pos -= Vector3Int(chunk_x, chunk_y, chunk_z) * CHUNK_WIDTH;
 
-    this->get_chunk(chunk_x, chunk_y, chunk_z)->set(pos, value);
-    this->send_data(Vector3Int(chunk_x, chunk_y, chunk_z));
+    Chunk* chunk = this->get_chunk(chunk_x, chunk_y, chunk_z);
+
+    // far chunks only have their lod resolution, editing needs every voxel
+    // generated outside the lock so the render thread keeps uploading meanwhile
+    CellStorage* full_resolution = nullptr;
+    if (chunk->is_fully_generated() && chunk->get_resolution() != CHUNK_RESOLUTION)
+        full_resolution = Chunk::generate_storage(*(this->generator), Vector3Int(chunk_x, chunk_y, chunk_z), CHUNK_RESOLUTION);
+
+    CellStorage* replaced = nullptr;
+    {
+        #ifndef DISABLE_THREAD
+        // the render thread may be copying the flatten data of this chunk
+        std::lock_guard<mingw_stdthread::mutex> guard(*this->upload_lock);
+        #endif
+        if (full_resolution != nullptr) replaced = chunk->replace_cells(full_resolution);
+
+        chunk->set(pos, value);
+    }
+    // neighbours being generated can still read the coarse cells
+    if (replaced != nullptr) this->retire_cells(replaced);
+    // flattened and staged once, with the edit
+    this->queue_upload(Vector3Int(chunk_x, chunk_y, chunk_z));
 }
 
 bool World::in_bounds(Vector3 position) {
@@ -283,7 +393,7 @@ void World::regenerate_chunk(Vector3Int chunk_position) {
             *(this->generator),
             chunk_position,
             this->compute_lod(chunk_position));
-    this->send_data(chunk_position);
+    this->queue_upload(chunk_position);
     #endif
 }
 
@@ -4,18 +4,22 @@
 #include <iostream>
 #ifndef DISABLE_THREAD
 #include "../../mingw_stdthreads/mingw.thread.h"
+#include "../../mingw_stdthreads/mingw.mutex.h"
 #endif
 #include <atomic>
 
 #include <vector>
 #include <queue>
 #include <chrono>
+#include <cstring>
 
 #include "./materials.h"
 #include "./world_generator.h"
 class WorldGenerator;
 #include "./chunk.h"
 class Chunk;
+struct GPUCell;
+struct CellStorage;
 
 #include "../utility/math/vector3.h"
 #ifndef DISABLE_BUFFER
@@ -23,6 +27,8 @@ class Chunk;
 #endif
 
 #define GPU_CELL_UNUSED_OFFSET 1
+// bytes of each of the upload ring segments (one per frame in flight)
+#define UPLOAD_SEGMENT_SIZE (CELL_MEMORY_SIZE << 16)
 
 struct RaycastHit{
     Vector3 hit_point = Vector3(0, 0, 0);
@@ -51,8 +57,19 @@ private:
 
     GrowableBuffer data_buffer;
     Buffer index_buffer;
+    UploadRing* upload_ring = nullptr;
+    #endif
+    // chunks flattened by the simulation, copied to the gpu by the next upload_pending
+    std::vector<Vector3Int> pending_uploads;
+    // cells replaced while generation threads may still read them, freed once none is running
+    std::vector<CellStorage*> retired_cells;
+    #ifndef DISABLE_THREAD
+    // held while the cells or the flatten data of a chunk change, and while the render thread copies them
+    // (allocated, World is copied when constructed)
+    mingw_stdthread::mutex* upload_lock = nullptr;
     #endif
 
+    void queue_upload(Vector3Int chunk_pos);
     RaycastHit get_next_cell(unsigned int& cell_size, Vector3 position, Vector3 direction);
     unsigned int compute_lod(Vector3Int chunk_position);
 public:
@@ -60,11 +77,24 @@ public:
     World(unsigned int loading_radius, WorldGenerator* generator);
     void load_circle(int radius);
 
+    // simulation side: starts the generations and queues the chunks that are done
     void update(float max_time);
+    // render side (thread of the gl context), once per frame: copies the queued chunks to the gpu
+    void upload_pending();
+    // every ring is loaded and no chunk is still generating
+    bool is_loaded();
+    // free storage once no generation thread can read it anymore (any thread)
+    void retire_cells(CellStorage* storage);
 
     void dispose();
     #ifndef DISABLE_BUFFER
-    void create_buffer(GLuint data_buffer_binding, GLuint index_buffer_binding);
+    // without a device the buffers use OpenGL
+    void create_buffer(GLuint data_buffer_binding, GLuint index_buffer_binding, BufferDevice* device = nullptr);
+    // write the data into the upload ring (any thread), invalid region if there is no room
+    UploadRegion stage_upload(std::vector<GPUCell>& data);
+    void release_upload(UploadRegion& region);
+    // seconds the last update waited for the gpu to free an upload ring segment
+    float get_upload_stall_time();
     #endif
     void send_data();
     void send_data(Vector3Int chunk_pos_modified);
@@ -1,12 +1,30 @@
 #ifndef _WORLD_GENERATOR_CLASS
 
 #include "./world_generator.h"
+#include "./generator_pipeline.h"
 
+#pragma region Heightmap
+float Heightmap::get(int x, int y) {
+    return this->heights[x * this->width + y];
+}
+#pragma endregion
+
+#pragma region WorldGenerator
 WorldGenerator::WorldGenerator() {};
 WorldGenerator::WorldGenerator(float block_size) {
     this->block_size = block_size;
 }
-unsigned int WorldGenerator::generate_value(Vector3 cell_pos) {
+WorldGenerator::WorldGenerator(float block_size, unsigned int seed, bool caves) {
+    this->block_size = block_size;
+    this->terrain = TerrainType::Noise;
+    this->caves = caves;
+    this->terrain_noise = Noise(seed, NoiseType::Simplex, 4, TERRAIN_FREQUENCY);
+    this->cave_noise = Noise(seed * 2 + 1, NoiseType::Perlin, 2, CAVE_FREQUENCY);
+}
+
+float WorldGenerator::ground_level(float x, float y) {
+    if (this->terrain == TerrainType::Noise) return this->terrain_noise.sample(x, y) * TERRAIN_HEIGHT;
+
     float weight = 8;
     float size = 16;
 
@@ -14,27 +32,135 @@ unsigned int WorldGenerator::generate_value(Vector3 cell_pos) {
 
     for (int i = 0; i < 3; i++)
     {
-        ground_level += (sin(cell_pos.x / size) + cos(cell_pos.y / size)) * weight;
+        ground_level += (sin(x / size) + cos(y / size)) * weight;
         weight /= 2;
         size /= 2;
     }
-    
-
-    if (cell_pos.z > ground_level) {
-        if (cell_pos.z < 0) {
+    return ground_level;
+}
+unsigned int WorldGenerator::get_material(float z, float ground_level) {
+    if (z > ground_level) {
+        if (z < WATER_LEVEL) {
             return MATERIAL_WATER;
         }
         return MATERIAL_AIR;
     }
-    else if (cell_pos.z > ground_level - 2) {
+    else if (z > ground_level - GRASS_DEPTH) {
         return MATERIAL_GRASS;
     }
-    else if (cell_pos.z > ground_level - 8) {
+    else if (z > ground_level - DIRT_DEPTH) {
         return MATERIAL_DIRT;
     }
     else {
         return MATERIAL_STONE;
     }
 }
+float WorldGenerator::cave_density(float x, float y, float z) {
+    if (this->density_lattice == 0) return fabsf(this->cave_noise.sample(x, y, z)) - CAVE_THRESHOLD;
+
+    // same operations as CaveStage so both give the same voxels
+    float spacing = this->density_lattice;
+    float x0 = floorf(x / spacing) * spacing;
+    float y0 = floorf(y / spacing) * spacing;
+    float z0 = floorf(z / spacing) * spacing;
+    float fx = (x - x0) / spacing;
+    float fy = (y - y0) / spacing;
+    float fz = (z - z0) / spacing;
+
+    float levels[2];
+    for (int i = 0; i < 2; i++)
+    {
+        float z_level = z0 + i * spacing;
+        float low = density_lerp(this->cave_noise.sample(x0, y0, z_level), this->cave_noise.sample(x0 + spacing, y0, z_level), fx);
+        float high = density_lerp(this->cave_noise.sample(x0, y0 + spacing, z_level), this->cave_noise.sample(x0 + spacing, y0 + spacing, z_level), fx);
+        levels[i] = density_lerp(low, high, fy);
+    }
+    return fabsf(density_lerp(levels[0], levels[1], fz)) - CAVE_THRESHOLD;
+}
+void WorldGenerator::set_density_lattice(unsigned int spacing) {
+    this->density_lattice = spacing;
+}
+unsigned int WorldGenerator::get_density_lattice() {
+    return this->density_lattice;
+}
+unsigned int WorldGenerator::generate_value(Vector3 cell_pos) {
+    unsigned int material = this->get_material(cell_pos.z, this->ground_level(cell_pos.x, cell_pos.y));
+    if (this->caves && Materials::is_solid(material) && this->cave_density(cell_pos.x, cell_pos.y, cell_pos.z) < 0) return MATERIAL_AIR;
+    return material;
+}
+
+void WorldGenerator::generate_heightmap(Heightmap& heightmap, Vector3Int origin, unsigned int width, unsigned int step) {
+    heightmap.width = width;
+    heightmap.heights.resize(width * width);
+    // columns at the center of each square of step voxels
+    origin = origin + Vector3Int(step / 2, step / 2, 0);
+    int stride = step;
+
+    if (this->terrain == TerrainType::Noise) {
+        // one row at a time through the batched noise kernels
+        std::vector<float> xs = std::vector<float>(width);
+        std::vector<float> ys = std::vector<float>(width);
+        for (int y = 0; y < width; y++) ys[y] = origin.y + y * stride;
+        for (int x = 0; x < width; x++)
+        {
+            std::fill(xs.begin(), xs.end(), (float)(origin.x + x * stride));
+            float* row = &heightmap.heights[x * width];
+            this->terrain_noise.sample(&xs[0], &ys[0], row, width);
+            for (int y = 0; y < width; y++) row[y] *= TERRAIN_HEIGHT;
+        }
+    }
+    else {
+        for (int x = 0; x < width; x++)
+        for (int y = 0; y < width; y++)
+        {
+            heightmap.heights[x * width + y] = this->ground_level(origin.x + x * stride, origin.y + y * stride);
+        }
+    }
+
+    float min_height = INFINITY;
+    float max_height = -INFINITY;
+    for (int i = 0; i < width * width; i++)
+    {
+        min_height = fminf(min_height, heightmap.heights[i]);
+        max_height = fmaxf(max_height, heightmap.heights[i]);
+    }
+
+    heightmap.min_height = min_height;
+    heightmap.max_height = max_height;
+}
+void fill_cells(Cell*** cells, unsigned int width, Cell cell) {
+    for (unsigned int x = 0; x < width; x++)
+    for (unsigned int y = 0; y < width; y++)
+    {
+        std::fill(cells[x][y], cells[x][y] + width, cell);
+    }
+}
+void WorldGenerator::generate_chunk(Cell*** cells, Vector3Int origin, unsigned int width, unsigned int step) {
+    GenerationContext context = GenerationContext(cells, origin, width, step);
+    // the heightmap tells which stages the chunk needs
+    HeightmapStage(*this).prepare(context);
+
+    int bottom = origin.z + context.sample_offset(0);
+    int top = origin.z + context.sample_offset(width - 1);
+
+    // fully above the surface and the water
+    if (bottom > context.heightmap.max_height && bottom >= WATER_LEVEL) {
+        fill_cells(cells, width, Cell{ MATERIAL_AIR });
+        return;
+    }
+
+    // fully under the dirt layer, only the caves can change the stone
+    if (top <= context.heightmap.min_height - DIRT_DEPTH) {
+        fill_cells(cells, width, Cell{ MATERIAL_STONE });
+        if (this->caves) make_pipeline(CaveStage(*this)).generate(context);
+        return;
+    }
+
+    if (this->caves)
+        make_pipeline(StrataStage(), CaveStage(*this), WaterStage()).generate(context);
+    else
+        make_pipeline(StrataStage(), WaterStage()).generate(context);
+}
+#pragma endregion
 
 #endif
\ No newline at end of file
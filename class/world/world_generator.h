@@ -7,18 +7,72 @@
 #include "./materials.h"
 #include "./world.h"
 #include "../utility/math/vector3.h"
+#include "../utility/math/noise.h"
+
+#define WATER_LEVEL 0
+#define GRASS_DEPTH 2
+#define DIRT_DEPTH 8
+
+#define TERRAIN_HEIGHT 24
+#define TERRAIN_FREQUENCY (1.0f / 128)
+#define CAVE_FREQUENCY (1.0f / 32)
+// caves are carved where the absolute value of the cave noise is below this
+#define CAVE_THRESHOLD 0.08f
+
+enum class TerrainType { Sine, Noise };
 
 class Cell;
 
+// ground level of every column of a chunk, indexed by x * width + y
+struct Heightmap
+{
+    std::vector<float> heights;
+    unsigned int width = 0;
+    float min_height = 0;
+    float max_height = 0;
+
+    float get(int x, int y);
+};
+
 class WorldGenerator
 {
 private:
     float block_size = 1;
+    TerrainType terrain = TerrainType::Sine;
+    bool caves = false;
+    Noise terrain_noise;
+    Noise cave_noise;
+
+    // spacing of the cave density lattice, 0 evaluates the noise at every voxel
+    unsigned int density_lattice = 0;
+
+    friend class CaveStage;
 public:
     WorldGenerator();
     WorldGenerator(float block_size);
+    // noise based terrain, optionally with 3D caves
+    WorldGenerator(float block_size, unsigned int seed, bool caves = true);
     unsigned int generate_value(Vector3 cell_pos);
-    void populate_cell(Cell& cell, Vector3Int cell_pos, unsigned int cell_size);
+
+    // height of the terrain surface, only depends on the column
+    float ground_level(float x, float y);
+    // material of a voxel at height z in a column whose surface is at ground_level
+    unsigned int get_material(float z, float ground_level);
+    // negative inside caves
+    float cave_density(float x, float y, float z);
+
+    // sample the cave noise every spacing voxels and trilinearly interpolate in between
+    // spacing should be a power of two up to the chunk width, 0 goes back to exact evaluation
+    void set_density_lattice(unsigned int spacing);
+    unsigned int get_density_lattice();
+
+    // compute the ground level of width x width columns of the area starting at origin (z is ignored)
+    // one column every step voxels, at the center of its square of step x step columns
+    void generate_heightmap(Heightmap& heightmap, Vector3Int origin, unsigned int width, unsigned int step = 1);
+    // fill cells[x][y][z] for a whole chunk through a GeneratorPipeline (see generator_pipeline.h)
+    // gives the same values as generate_value, at the center of each cube of step voxels when step > 1
+    // chunks above the surface and the water, or under the dirt layer, skip the stages they do not need
+    void generate_chunk(Cell*** cells, Vector3Int origin, unsigned int width, unsigned int step = 1);
 };
 
 #endif
\ No newline at end of file
@@ -8,16 +8,22 @@
 #include "class/world/world_generator.h"
 #include "class/world/world.h"
 #include "class/gameplay/player.h"
+#include "class/gameplay/simulation.h"
 
 const int SCREEN_WIDTH = 1080;
 const int SCREEN_HEIGHT = 768;
 
 #define WORLD_DATA_BUFFER_BINDING 1
 #define WORLD_INDEX_BUFFER_BINDING 2
+// material_layout of materials.glsl, after the compute renderer buffers (RAY_BUFFER_BINDING)
+#define MATERIAL_BUFFER_BINDING 7
 
 #define PLAYER_SPEED 8
 #define LOADING_RADIUS 5
 
+// startup time is measured from here to the first presented frame
+const auto process_start = std::chrono::steady_clock::now();
+
 float get_time_from(std::chrono::_V2::system_clock::time_point point) {
     auto end = std::chrono::system_clock::now();
     std::chrono::duration<double> elapsed_time = end-point;
@@ -31,7 +37,25 @@ int main(int argc, char *args[]) {
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 
     Screen screen = Screen(SCREEN_WIDTH, SCREEN_HEIGHT);
-    screen.setup_base_shaders("./shader/test.frag");
+    // constants the shader folds, the chunk layout has to match the one of the world
+    unsigned int quality = 2;
+    screen.set_shader_define("CHUNK_RESOLUTION", std::to_string(CHUNK_RESOLUTION));
+    screen.set_shader_define("MATERIAL_COUNT", std::to_string(MATERIAL_COUNT));
+    // --render-scale 0.5 fixes the scale (benchmarks), --frame-budget 8 sets the gpu time target in ms
+    // --temporal 1 traces every pixel each frame (no reprojection), --depth-prepass 0 starts every ray at the camera
+    // --renderer compute starts with the compute renderer (F6 switches), --quality 0 to 2 (F7 cycles)
+    bool compute_renderer = false;
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(args[i]) == "--render-scale") screen.set_fixed_render_scale(atof(args[i + 1]));
+        if (std::string(args[i]) == "--frame-budget") screen.set_frame_time_target(atof(args[i + 1]) / 1000);
+        if (std::string(args[i]) == "--temporal") screen.set_temporal_block(atoi(args[i + 1]));
+        if (std::string(args[i]) == "--depth-prepass") screen.set_depth_prepass(atoi(args[i + 1]) != 0);
+        if (std::string(args[i]) == "--renderer") compute_renderer = std::string(args[i + 1]) == "compute";
+        if (std::string(args[i]) == "--quality") quality = __min(2U, (unsigned int)atoi(args[i + 1]));
+    }
+    screen.set_shader_define("QUALITY", std::to_string(quality));
+    screen.start_base_shaders("./shader/test.frag");
     SDL_SetRelativeMouseMode(SDL_TRUE);
 
     WorldGenerator generator = WorldGenerator(1);
@@ -39,20 +63,48 @@ int main(int argc, char *args[]) {
     #ifndef DISABLE_BUFFER
     world.create_buffer(WORLD_DATA_BUFFER_BINDING, WORLD_INDEX_BUFFER_BINDING);
     #endif
+    // the look of every material, read by the shader
+    std::vector<GPUMaterial> material_table = Materials::get_gpu_table();
+    Buffer material_buffer = Buffer(true);
+    material_buffer.set_data(material_table.size() * sizeof(GPUMaterial), &material_table[0]);
+    material_buffer.bind_buffer(MATERIAL_BUFFER_BINDING);
     world.send_data();
 
+    // generate the first rings while the driver compiles the shaders
+    while (!screen.is_shader_ready() && !world.is_loaded()) {
+        world.update(0);
+        world.upload_pending();
+    }
+    screen.finish_base_shaders();
+    if (compute_renderer) screen.set_compute_renderer(true);
+
     Player player = Player(
         Vector3(
             0,
             0,
             CHUNK_WIDTH + 0.01
         )
-        , &screen, &world);
+        , &world);
+    // the simulation thread spreads the entity systems on the workers
+    JobSystem jobs;
+    EntityStore entities = EntityStore(&world, &jobs);
+    // from here the world, the player and the entities belong to the simulation thread
+    Simulation simulation(&player, &world, &entities);
+    simulation.start();
 
     bool loop = true;
+    bool first_frame = true;
     float deltatime = 0.001;
+    // time waited on the upload ring fences and gl calls made, reported once per second
+    float upload_stall_time = 0;
+    unsigned int gl_calls = 0;
+    float report_time = 0;
+    unsigned int report_frames = 0;
+    // input events and cursor raycasts are totals of the snapshots, the report shows the difference
+    FrameSnapshot report_snapshot = simulation.get_snapshot();
     while (loop) {
         auto frame_start = std::chrono::system_clock::now();
+        reset_gl_call_count();
 
         SDL_Event e;
         while (SDL_PollEvent(&e)) {
@@ -71,6 +123,15 @@ int main(int argc, char *args[]) {
                     case SDLK_F5:
                         world.send_data();
                         break;
+                    case SDLK_F6:
+                        screen.set_compute_renderer(!screen.is_compute_renderer());
+                        std::cout << (screen.is_compute_renderer() ? "compute" : "fragment") << " renderer\n";
+                        break;
+                    case SDLK_F7:
+                        quality = (quality + 1) % 3;
+                        screen.set_shader_define("QUALITY", std::to_string(quality));
+                        if (screen.rebuild_shaders()) std::cout << "quality " << quality << "\n";
+                        break;
                     case SDLK_F12:
                         screen.set_full_screen(!screen.is_full_screen());
                         break;
@@ -78,36 +139,76 @@ int main(int argc, char *args[]) {
                 break;
             }
 
-            player.process_specific_event(e, deltatime);
+            simulation.push_event(e);
         }
+        simulation.set_input_state(SDL_GetKeyboardState(NULL), SDL_GetMouseState(NULL, NULL));
+        simulation.update(deltatime);
         
+        // the chunks changed by the last ticks
         auto world_start = std::chrono::system_clock::now();
-        world.update(0);
+        world.upload_pending();
         float world_time = get_time_from(world_start);
+        #ifndef DISABLE_BUFFER
+        upload_stall_time += world.get_upload_stall_time();
+        #endif
         
-        auto player_start = std::chrono::system_clock::now();
-        player.process_events(deltatime);
-        player.update(deltatime);
-        float player_time = get_time_from(player_start);
+        FrameSnapshot snapshot = simulation.get_snapshot();
+        PlayerView view = simulation.get_view(snapshot);
+        screen.set_player_position(view.position);
+        screen.set_facing(view.pitch, view.yaw);
+        screen.set_FOV(view.FOV);
+        screen.set_player_target(view.target);
+        screen.set_pick_tick(snapshot.tick);
+        // read back from an older frame, never waited for
+        PickResult pick;
+        if (screen.get_pick(pick)) simulation.set_pick(pick);
+        float player_time = simulation.get_tick_time();
     
         auto render_start = std::chrono::system_clock::now();
         screen.render();
-        float render_time = get_time_from(player_start);
+        float render_time = get_time_from(render_start);
 
         screen.update();
-        screen.set_uniform("debug_time", world_time, player_time, render_time);
+        screen.set_debug_time(world_time, player_time, render_time);
+        if (first_frame) {
+            std::chrono::duration<double> startup_time = std::chrono::steady_clock::now() - process_start;
+            std::cout << "startup: " << startup_time.count() * 1000 << "ms to the first frame (shaders "
+                << screen.get_shader_time() * 1000 << "ms, " << (screen.is_shader_from_cache() ? "cached" : "compiled") << ")\n";
+            first_frame = false;
+        }
+        gl_calls += get_gl_call_count();
 
         auto frame_end = std::chrono::system_clock::now();
         std::chrono::duration<double> elapsed_time = frame_end-frame_start;
         double elapsed_seconds = elapsed_time.count();
         deltatime = elapsed_seconds;
+
+        report_time += deltatime;
+        report_frames++;
+        if (report_time >= 1) {
+            if (upload_stall_time > 0) std::cout << "upload stall: " << upload_stall_time * 1000 / report_frames << "ms per frame\n";
+            std::cout << "input: " << (float)(snapshot.events - report_snapshot.events) / report_frames << " events, "
+                << (float)(snapshot.cursor_raycasts - report_snapshot.cursor_raycasts) / report_frames << " cursor raycasts, "
+                << (float)(snapshot.picks_used - report_snapshot.picks_used) / report_frames << " gpu picks used per frame ("
+                << snapshot.tick - report_snapshot.tick << " ticks, " << snapshot.entities << " entities)\n";
+            report_snapshot = snapshot;
+            std::cout << "gl calls: " << (float)gl_calls / report_frames << " per frame, render scale "
+                << screen.get_render_scale() << " (scene " << screen.get_scene_time() * 1000 << "ms)\n";
+            upload_stall_time = 0;
+            gl_calls = 0;
+            report_time = 0;
+            report_frames = 0;
+        }
         // std::cout << "time to render frame : " << elapsed_seconds << " (fps : " << 1/elapsed_seconds << ")\n";
         
-        screen.set_uniform("deltatime", deltatime);
+        screen.set_deltatime(deltatime);
         // std::cout << "time to render frame : " << elapsed_seconds << " (fps : " << 1/elapsed_seconds << ")\n";
     }
 
+    simulation.stop();
+    jobs.dispose();
     world.dispose();
+    material_buffer.dispose();
 
     screen.close();
 
@@ -0,0 +1,28 @@
+// the registry of materials.h, uploaded by the engine: adding a material needs no change here
+#define AIR 0
+
+// same bits as materials.h
+#define MATERIAL_SEE_THROUGH 1u
+#define MATERIAL_SOLID 2u
+#define MATERIAL_WAVES 4u
+
+// GPUMaterial of materials.h
+struct Material {
+    vec3 color;
+    float reflection;
+    vec3 emision_color;
+    float emision_strength;
+    vec3 volume_color;
+    float volume;
+    float ior;
+    float transparency;
+    uint flags;
+    uint padding;
+};
+// one entry per id, then the one of every unknown id
+layout(std430, binding = 7) readonly buffer material_layout {
+    Material materials[];
+};
+Material get_material(uint value) {
+    return materials[min(value, uint(materials.length()) - 1u)];
+}
\ No newline at end of file
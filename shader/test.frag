@@ -1,58 +1,82 @@
 #version 430 core
 #define PI 3.1415926535897932384626433832795
 
-out vec4 LFragment;
+// built as a compute shader too, with COMPUTE_RENDERER defined after the version line
+#ifdef COMPUTE_RENDERER
+layout(local_size_x = 256) in;
+layout(rgba8, binding = 0) uniform writeonly image2D scene_image;
+// rgb: color, a: distance from the camera to the first hit, negative if it can't be reprojected
+layout(rgba16f, binding = 1) uniform writeonly image2D history_image;
+#else
+layout(location = 0) out vec4 LFragment;
+// rgb: color, a: distance from the camera to the first hit, negative if it can't be reprojected
+layout(location = 1) out vec4 history;
 in vec4 gl_FragCoord;
-
-uniform vec2 WindowSize;
-uniform float time; // within [0, 1000] in seconds
-uniform float deltatime;
-uniform vec3 debug_time;
-
-uniform vec3 player_position;
-uniform vec3 player_target;
-uniform float facing_pitch;
-uniform float facing_yaw;
-uniform float FOV;
-
+#endif
+
+// sent once per frame, same layout as FrameUniforms (screen.h)
+layout(std140, binding = 0) uniform frame_data {
+    vec3 player_position;
+    float time; // within [0, 1000] in seconds
+    vec3 player_target;
+    float deltatime;
+    vec3 debug_time;
+    float facing_pitch;
+    vec2 WindowSize;
+    float facing_yaw;
+    float FOV;
+    float render_scale; // scene pixels per window pixel
+    float previous_pitch;
+    float previous_yaw;
+    float previous_render_scale;
+    vec3 previous_position;
+    uint frame_index;
+    uint temporal_block; // one tile of each temporal_block² group is traced each frame, 1 traces them all
+    uint history_valid;
+    float previous_FOV;
+    uint depth_prepass; // 1 when tile_depth holds the pre-pass of this frame
+};
+layout(binding = 0) uniform sampler2D previous_history;
+// distance from the camera every ray of a DEPTH_TILE x DEPTH_TILE tile can skip
+layout(binding = 1) uniform sampler2D tile_depth;
+// 1 while drawing tile_depth (one pixel per tile), 0 for the scene
+uniform uint depth_pass;
+// gl_FragCoord (or the pixel of the invocation) in scene pixels
+vec2 pixel_coord;
+// pixel_coord in window pixels, the scene is rendered at render_scale then stretched
+vec2 frag_coord;
+
+// injected by the engine (Screen::set_shader_define), the values here only serve when the shader is compiled alone
+#ifndef CHUNK_RESOLUTION
+#define CHUNK_RESOLUTION 5
+#endif
+// ids of materials.h, the materials themselves come from the material buffer
+#ifndef MATERIAL_COUNT
+#define MATERIAL_COUNT 7
+#endif
+// 0 low, 1 medium, 2 high
+#ifndef QUALITY
+#define QUALITY 2
+#endif
+const uint CHUNK_WIDTH = 1u << CHUNK_RESOLUTION;
+
+#if QUALITY == 0
+const float MAX_DISTANCE = 128;
+const uint MAX_BOUNCE = 1;
+#elif QUALITY == 1
+const float MAX_DISTANCE = 192;
+const uint MAX_BOUNCE = 2;
+#else
 const float MAX_DISTANCE = 256;
-const int MAX_ITER = int(ceil(MAX_DISTANCE / 2));
 const uint MAX_BOUNCE = 3;
+#endif
+const int MAX_ITER = int(ceil(MAX_DISTANCE / 2));
+const uint TEMPORAL_TILE = 8; // pixels traced or reprojected together (a warp / wavefront)
+const uint DEPTH_TILE = 8; // scene pixels per pre-pass pixel, on each axis
+const int BEAM_ITER = 64;
 
 //#region Materials
-#define AIR 0
-#define GRASS 1
-#define DIRT 2
-#define STONE 3
-#define WATER 4
-#define BUILDING 5
-#define LIGHT 6
-#define START_MATERIAL LIGHT
-
-const struct Material {
-    vec3 color;
-    float reflection;
-    float ior;
-    float transparency;
-    vec3 emision_color;
-    float emision_strength;
-    vec3 volume_color;
-    float volume;
-} materials[7] = Material[](
-    //         color          reflection       IOR    transparency    emission          emission_strength    volume_color     volume
-    Material(vec3(0, 0, 0),         0,          1,          1,      vec3(0, 0, 0),             0,            vec3(0.5, 1, 1),   .005),  // air
-    Material(vec3(0, .75, 0),       0,          1,          0,      vec3(0, 0, 0),             0,            vec3(0, 0, 0),        0),  // grass
-    Material(vec3(.4, .2, .1),      0,          1,          0,      vec3(0, 0, 0),             0,            vec3(0, 0, 0),        0),  // dirt
-    Material(vec3(.25, .25, .25),   0,          1,          0,      vec3(0, 0, 0),             0,            vec3(0, 0, 0),        0),  // stone
-    Material(vec3(0.75, 1, 1),      .75,        1.333,      .75,    vec3(0, 0, 0),             0,            vec3(0, .75, .5),   .15),  // water
-    Material(vec3(1, .3, 0),        0,          1,          0,      vec3(0, 0, 0),             0,            vec3(0, 0, 0),        0),  // building
-    Material(vec3(.9, .9, 1),      .8,          1,          0,      vec3(.9, .9, 1),      /*3*/0,            vec3(0, 0, 0),        0)   // light
-);
-#define UNKNOWN_MATERIAL Material(vec3(1, 0, 1), 0, 1, 0, vec3(1, 0, 1), 1, vec3(0), 0)
-Material get_material(uint value) {
-    if (value > START_MATERIAL) return UNKNOWN_MATERIAL;
-    return materials[value];
-}
+#include "materials.glsl"
 //#endregion
 
 //#region Data
@@ -65,62 +89,128 @@ layout(std430, binding = 1) readonly buffer world_data_layout {
 };
 layout(std430, binding = 2) readonly buffer world_indexes_layout {
     uint world_width;
-    uint chunk_width;
+    uint chunk_width; // CHUNK_WIDTH, the constant is used so the lookups fold it
     uint world_indexes[];
 };
 
-bool in_bounds(vec3 pos) {
-    return 
-        abs(pos.x) <= chunk_width * ((world_width-1) >> 1) &&
-        abs(pos.y) <= chunk_width * ((world_width-1) >> 1) &&
-        abs(pos.z) <= chunk_width * ((world_width-1) >> 1);
-}
 struct ValueSize { uint value; uint size; };
-ValueSize get_cell_value(vec3 index) {
-    if (!in_bounds(index)) return ValueSize(AIR, chunk_width);
-
-    int chunk_x = int(floor(index.x / chunk_width));
-    int chunk_y = int(floor(index.y / chunk_width));
-    int chunk_z = int(floor(index.z / chunk_width));
-    uint x = uint(mod(index.x, chunk_width));
-    uint y = uint(mod(index.y, chunk_width));
-    uint z = uint(mod(index.z, chunk_width));
-    chunk_x -= int(world_width) * int(floor(float(chunk_x) / world_width));
-    chunk_y -= int(world_width) * int(floor(float(chunk_y) / world_width));
-    chunk_z -= int(world_width) * int(floor(float(chunk_z) / world_width));
-
-    uint temp_index = world_width * (world_width * chunk_x + chunk_y) + chunk_z;
-    if (temp_index >= world_width * world_width * world_width) return ValueSize(AIR, chunk_width);
-
-    uint chunk_index = world_indexes[temp_index];
-    if (chunk_index == 0) return ValueSize(AIR, chunk_width);
-    chunk_index -= 1;
-    uint cell_offset = 0;
-
-    uint current_cell_width = chunk_width;
-    while (current_cell_width > 1) {
-        current_cell_width >>= 1;
-        
+
+#ifdef COMPUTE_RENDERER
+// the whole chunk index, loaded by each workgroup when it fits
+const uint INDEX_CACHE_SIZE = 4096;
+shared uint index_cache[INDEX_CACHE_SIZE];
+bool index_cached = false;
+void load_index_cache() {
+    uint count = world_width * world_width * world_width;
+    index_cached = count <= INDEX_CACHE_SIZE;
+    if (index_cached)
+        for (uint i = gl_LocalInvocationIndex; i < count; i += gl_WorkGroupSize.x) index_cache[i] = world_indexes[i];
+    barrier();
+}
+uint get_chunk_root(uint index) {
+    return index_cached ? index_cache[index] : world_indexes[index];
+}
+#else
+uint get_chunk_root(uint index) {
+    return world_indexes[index];
+}
+#endif
+
+// where the last lookup of a ray ended, the next one only climbs to the node shared by both cells
+// the stack holds 6 levels of 16 bits, a wider chunk has more levels and more cells than it can address
+#if CHUNK_RESOLUTION > 5
+#error TreeCursor.stack only holds chunks of up to 32 cells wide, CHUNK_RESOLUTION 5
+#endif
+struct TreeCursor {
+    bool valid;
+    ivec3 chunk;   // chunk coordinates
+    uint root;     // world_indexes value of the chunk: data offset + 1, 0 if empty
+    uint depth;    // deepest node containing the last region
+    uvec3 stack;   // node offset of each level on 16 bits (a chunk of width 32 has less than 2^16 cells), no array to spill
+    ivec3 origin;  // last region, same value and size
+    uint size;
+    uint value;
+};
+TreeCursor new_cursor() {
+    TreeCursor cursor;
+    cursor.valid = false;
+    return cursor;
+}
+bool in_bounds(ivec3 cell) {
+    int limit = int(CHUNK_WIDTH * ((world_width-1) >> 1));
+    return all(lessThanEqual(abs(cell), ivec3(limit)));
+}
+void tree_lookup(inout TreeCursor cursor, ivec3 cell) {
+    const int chunk_shift = CHUNK_RESOLUTION;
+    ivec3 chunk = cell >> chunk_shift;
+    uvec3 local = uvec3(cell & int(CHUNK_WIDTH - 1));
+
+    if (!in_bounds(cell)) {
+        cursor.valid = false;
+        cursor.origin = chunk << chunk_shift;
+        cursor.size = CHUNK_WIDTH;
+        cursor.value = AIR;
+        return;
+    }
+
+    if (cursor.valid && cursor.chunk == chunk) {
+        // the node of the last region at the level of the highest differing bit contains both
+        uvec3 diff = local ^ uvec3(cursor.origin & int(CHUNK_WIDTH - 1));
+        int level = chunk_shift - 1 - findMSB(diff.x | diff.y | diff.z);
+        cursor.depth = min(cursor.depth, uint(level));
+    }
+    else {
+        // in bounds chunk > -world_width, the sum stays positive (% is undefined for negative values)
+        uvec3 wrapped = uvec3(chunk + int(world_width)) % world_width;
+        cursor.valid = true;
+        cursor.chunk = chunk;
+        cursor.root = get_chunk_root(world_width * (world_width * wrapped.x + wrapped.y) + wrapped.z);
+        cursor.depth = 0;
+        cursor.stack = uvec3(0);
+    }
+
+    if (cursor.root == 0) {
+        cursor.origin = chunk << chunk_shift;
+        cursor.size = CHUNK_WIDTH;
+        cursor.value = AIR;
+        return;
+    }
+
+    uint chunk_index = cursor.root - 1;
+    uint cell_offset = (cursor.stack[cursor.depth >> 1] >> ((cursor.depth & 1u) << 4)) & 0xFFFFu;
+    int width_shift = chunk_shift - int(cursor.depth);
+    while (width_shift > 0) {
+        width_shift--;
+
         // (x, y, z) -> ²xyz
         // (0, 1, 0) -> ²010 = 2
-        uint code = (uint(x / current_cell_width) << 2) | (uint(y / current_cell_width) << 1) | uint(z / current_cell_width);
+        uvec3 bit = (local >> width_shift) & 1u;
+        uint code = (bit.x << 2) | (bit.y << 1) | bit.z;
 
-        if (world_data[chunk_index + cell_offset].sub_cell[code] == 0) {
-            current_cell_width <<= 1;
+        uint sub_cell = world_data[chunk_index + cell_offset].sub_cell[code];
+        if (sub_cell == 0) {
+            // empty child: the value of the node over the child, or over the whole node if it has no child at all
+            width_shift++;
             for (int i = 0; i < 8; i++) if (world_data[chunk_index + cell_offset].sub_cell[i] != 0) {
-                current_cell_width >>= 1;
+                width_shift--;
                 break;
             }
             break;
         }
-        cell_offset = world_data[chunk_index + cell_offset].sub_cell[code];
-
-        x %= current_cell_width;
-        y %= current_cell_width;
-        z %= current_cell_width;
+        cell_offset = sub_cell;
+        cursor.depth++;
+        uint half_shift = (cursor.depth & 1u) << 4;
+        cursor.stack[cursor.depth >> 1] = (cursor.stack[cursor.depth >> 1] & ~(0xFFFFu << half_shift)) | (cell_offset << half_shift);
     }
 
-    return ValueSize(world_data[chunk_index + cell_offset].value, current_cell_width);
+    cursor.size = 1u << width_shift;
+    cursor.origin = cell & ~int(cursor.size - 1);
+    cursor.value = world_data[chunk_index + cell_offset].value;
+}
+ValueSize get_cell_value(vec3 index) {
+    TreeCursor cursor = new_cursor();
+    tree_lookup(cursor, ivec3(floor(index)));
+    return ValueSize(cursor.value, cursor.size);
 }
 //#endregion
 
@@ -229,20 +319,36 @@ mat3 rotation_matrix(vec3 axis, float angle) {
                 oc * axis.z * axis.x - axis.y * s,  oc * axis.y * axis.z + axis.x * s,  oc * axis.z * axis.z + c          );
 }
 
-vec3 get_direction() {
-    float x = (gl_FragCoord.x / WindowSize.x - 0.5) * 2;
-    float y = (gl_FragCoord.y / WindowSize.y - 0.5) * 2;
+vec3 get_direction(vec2 coord, float pitch, float yaw, float fov) {
+    float x = (coord.x / WindowSize.x - 0.5) * 2;
+    float y = (coord.y / WindowSize.y - 0.5) * 2;
     float aspect = WindowSize.x / WindowSize.y;
 
     vec3 direction = normalize(vec3(
-        1 / tan(FOV / 2),
+        1 / tan(fov / 2),
         aspect * x,
         y
     ));
-    direction = rotation_matrix(vec3(0, 1, 0), facing_pitch) * direction;
-    direction = rotation_matrix(vec3(0, 0, 1), -facing_yaw) * direction;
+    direction = rotation_matrix(vec3(0, 1, 0), pitch) * direction;
+    direction = rotation_matrix(vec3(0, 0, 1), -yaw) * direction;
     return direction;
 }
+vec3 get_direction() {
+    return get_direction(frag_coord, facing_pitch, facing_yaw, FOV);
+}
+// window coordinates of point seen by the previous camera, false if it is behind it
+bool project_previous(vec3 point, out vec2 coord) {
+    vec3 local = point - previous_position;
+    local = transpose(rotation_matrix(vec3(0, 0, 1), -previous_yaw)) * local;
+    local = transpose(rotation_matrix(vec3(0, 1, 0), previous_pitch)) * local;
+    if (local.x <= 0.001) return false;
+
+    float aspect = WindowSize.x / WindowSize.y;
+    vec2 xy = local.yz / (local.x * tan(previous_FOV / 2));
+    xy.x /= aspect;
+    coord = (xy * 0.5 + 0.5) * WindowSize;
+    return true;
+}
 //#endregion
 
 
@@ -337,26 +443,26 @@ RaycastHit raycast(vec3 direction, vec3 start_position, int max_step, float max_
     //#endregion
 
     int nb_steps = 0;
-    vec3 cell_pos = floor(start_position);
+    ivec3 cell_pos = ivec3(floor(start_position));
+    ivec3 cell_step = ivec3(sign(direction));
     vec3 position = start_position;
     vec3 normal = -direction;
     float distance = 0;
 
-    ValueSize vs = get_cell_value(cell_pos);
-    if (vs.value != ignored_material) return RaycastHit(vs.value, position, normal, nb_steps);
-    vec3 last_cell_pos = cell_pos;
+    TreeCursor cursor = new_cursor();
+    tree_lookup(cursor, cell_pos);
+    if (cursor.value != ignored_material) return RaycastHit(cursor.value, position, normal, nb_steps);
 
     while (nb_steps < max_step && distance < max_dist) {
 
-        if (floor(cell_pos / vs.size) != floor(last_cell_pos / vs.size)) {
+        if ((cell_pos & ~int(cursor.size - 1)) != cursor.origin) {
             nb_steps++;
-            vs = get_cell_value(cell_pos);
-            if (vs.value != ignored_material) return RaycastHit(vs.value, position, normal, nb_steps);
-            last_cell_pos = cell_pos;
+            tree_lookup(cursor, cell_pos);
+            if (cursor.value != ignored_material) return RaycastHit(cursor.value, position, normal, nb_steps);
         }
 
         if (next_dist_X <= next_dist_Y && next_dist_X <= next_dist_Z) {
-            cell_pos.x += sign(direction.x);
+            cell_pos.x += cell_step.x;
             position = next_pos_X;
             normal = vec3(-sign(direction.x), 0, 0);
             distance = next_dist_X;
@@ -364,7 +470,7 @@ RaycastHit raycast(vec3 direction, vec3 start_position, int max_step, float max_
             next_pos_X += step_X;
         }
         else if (next_dist_Y <= next_dist_Z) {
-            cell_pos.y += sign(direction.y);
+            cell_pos.y += cell_step.y;
             position = next_pos_Y;
             normal = vec3(0, -sign(direction.y), 0);
             distance = next_dist_Y;
@@ -372,7 +478,7 @@ RaycastHit raycast(vec3 direction, vec3 start_position, int max_step, float max_
             next_pos_Y += step_Y;
         }
         else {
-            cell_pos.z += sign(direction.z);
+            cell_pos.z += cell_step.z;
             position = next_pos_Z;
             normal = vec3(0, 0, -sign(direction.z));
             distance = next_dist_Z;
@@ -384,83 +490,107 @@ RaycastHit raycast(vec3 direction, vec3 start_position, int max_step, float max_
     return RaycastHit(AIR, start_position + direction * MAX_DISTANCE, -direction, nb_steps);
 }
 
-vec3 get_color() {
-    vec3 direction = get_direction();
-    int step_left = MAX_ITER;
-    float dist_left = MAX_DISTANCE;
-    vec3 pos = player_position + direction * 0.5;
-    uint start_value = get_cell_value(player_position).value;
-    Material start_material = get_material(start_value);
-
-    vec4 final_color = vec4(0, 0, 0, 0);
+// distance to the first hit of the last primary ray
+float primary_depth = MAX_DISTANCE;
+// a ray and what it gathered so far, traced one bounce at a time
+struct Ray {
+    vec3 pos;
+    vec3 direction;
+    vec4 color;
+    int step_left;
+    float dist_left;
+    uint start_value;
+    uint coord_offset;
+    float skip; // distance the next raycast can skip, from the depth pre-pass
+    uint hit_value;
+};
+// beam: distance from the camera found by the depth pre-pass for the tile, 0 if none
+Ray new_ray(float beam) {
+    Ray ray;
+    ray.direction = get_direction();
+    ray.step_left = MAX_ITER;
+    ray.dist_left = MAX_DISTANCE;
+    ray.pos = player_position + ray.direction * 0.5;
+    ray.start_value = get_cell_value(player_position).value;
+    ray.color = vec4(0, 0, 0, 0);
+    ray.coord_offset = 1;
+    ray.skip = max(0, beam - 0.5);
+    ray.hit_value = AIR;
+    return ray;
+}
+// raycast to the next hit and shade it, false when the ray is done
+bool trace_bounce(inout Ray ray, uint b) {
+    Material start_material = get_material(ray.start_value);
 
-    uint coord_offset = 1;
+    RaycastHit hit = raycast(ray.direction, ray.pos + ray.direction * ray.skip, ray.step_left, ray.dist_left - ray.skip, ray.start_value);
+    ray.skip = 0;
+    if (b == 0) primary_depth = distance(player_position, hit.hit_point);
+    ray.step_left -= hit.step_taken;
+    ray.dist_left -= distance(ray.pos, hit.hit_point);
+    if (ray.step_left <= 0 || ray.dist_left <= 0) return false;
 
-    for (uint b = 0; b <= MAX_BOUNCE; b++) {
-        RaycastHit hit = raycast(direction, pos, step_left, dist_left, start_value);
-        step_left -= hit.step_taken;
-        dist_left -= distance(pos, hit.hit_point);
-        if (step_left <= 0 || dist_left <= 0) break;
+    // add material volume
+    ray.color += vec4(start_material.volume_color, 1) * (1 - ray.color.w) * smooth_sign(start_material.volume * distance(ray.pos, hit.hit_point));
+    ray.pos = hit.hit_point;
+    ray.hit_value = hit.value;
 
-        // add material volume
-        final_color += vec4(start_material.volume_color, 1) * (1 - final_color.w) * smooth_sign(start_material.volume * distance(pos, hit.hit_point));
-        pos = hit.hit_point;
 
+    Material hit_material = get_material(hit.value);
 
-        Material hit_material = get_material(hit.value);
+    vec3 modified_normals = hit.normal;
+    //#region water normals
+    if ((hit_material.flags & MATERIAL_WAVES) != 0 /*INTO WATER*/) {
+        modified_normals = bump(modified_normals, ray.pos + vec3(time * 0.5, time, 0), 0.05, 1, 2);
+    }
+    else if ((start_material.flags & MATERIAL_WAVES) != 0 /*OUT OF WATER*/) {
+        modified_normals = bump(modified_normals, ray.pos + vec3(time * 0.5, time, 0), -0.05, 1, 2);
+    }
+    //#endregion
 
-        vec3 modified_normals = hit.normal;
-        //#region water normals
-        if (hit.value == WATER /*INTO WATER*/) {
-            modified_normals = bump(modified_normals, pos + vec3(time * 0.5, time, 0), 0.05, 1, 2);
-        }
-        else if (start_value == WATER /*OUT OF WATER*/) {
-            modified_normals = bump(modified_normals, pos + vec3(time * 0.5, time, 0), -0.05, 1, 2);
-        }
-        //#endregion
-
-        bool transparent_ray = hit_material.transparency != 0;
-        bool reflection_ray = hit_material.reflection != 0;
-        //#region transparency reflection conflict
-        if (transparent_ray && refract(direction, modified_normals, start_material.ior / hit_material.ior) == vec3(0)) { // switch to inner refraction
-            transparent_ray = false;
-            reflection_ray = true;
-        }
-        else if (transparent_ray && reflection_ray) {
-            coord_offset *= 2;
-            transparent_ray = int(gl_FragCoord.x+gl_FragCoord.y) % coord_offset < coord_offset / 2;
-            reflection_ray = !transparent_ray;
-        }
-        //#endregion
+    bool transparent_ray = hit_material.transparency != 0;
+    bool reflection_ray = hit_material.reflection != 0;
+    //#region transparency reflection conflict
+    if (transparent_ray && refract(ray.direction, modified_normals, start_material.ior / hit_material.ior) == vec3(0)) { // switch to inner refraction
+        transparent_ray = false;
+        reflection_ray = true;
+    }
+    else if (transparent_ray && reflection_ray) {
+        ray.coord_offset *= 2;
+        transparent_ray = int(pixel_coord.x+pixel_coord.y) % ray.coord_offset < ray.coord_offset / 2;
+        reflection_ray = !transparent_ray;
+    }
+    //#endregion
 
-        //#region compute hit_color
-        vec4 hit_color = vec4(hit_material.color, 1);
-        if (floor(hit.hit_point - hit.normal * 0.1) == floor(player_target)) hit_color = mix(hit_color, vec4(1, 1, 1, 1), 0.5);
+    //#region compute hit_color
+    vec4 hit_color = vec4(hit_material.color, 1);
+    if (floor(hit.hit_point - hit.normal * 0.1) == floor(player_target)) hit_color = mix(hit_color, vec4(1, 1, 1, 1), 0.5);
 
-        float light = clamp(-dot(hit.normal, normalize(vec3(-2, -4, -8))), 0.25, 1);
-        hit_color.xyz = (hit_color.xyz + hit_material.emision_color * hit_material.emision_strength) * light;
-        //#endregion
+    float light = clamp(-dot(hit.normal, normalize(vec3(-2, -4, -8))), 0.25, 1);
+    hit_color.xyz = (hit_color.xyz + hit_material.emision_color * hit_material.emision_strength) * light;
+    //#endregion
 
-        if (transparent_ray) {
-            final_color += hit_color * (1 - final_color.w) * (1 - hit_material.transparency);
+    if (transparent_ray) {
+        ray.color += hit_color * (1 - ray.color.w) * (1 - hit_material.transparency);
 
-            direction = refract(direction, modified_normals, start_material.ior / hit_material.ior);
-            pos -= hit.normal * 0.01;
+        ray.direction = refract(ray.direction, modified_normals, start_material.ior / hit_material.ior);
+        ray.pos -= hit.normal * 0.01;
 
-            start_value = hit.value;
-            start_material = hit_material;
-        }
-        else if (reflection_ray) {
-            final_color += hit_color * (1 - final_color.w) * (1 - hit_material.reflection);
+        ray.start_value = hit.value;
+        return true;
+    }
+    else if (reflection_ray) {
+        ray.color += hit_color * (1 - ray.color.w) * (1 - hit_material.reflection);
 
-            direction = reflect(direction, modified_normals);
-            pos += hit.normal * 0.01;
-        }
-        else {
-            final_color += hit_color * (1 - final_color.w);
-            break;
-        }
+        ray.direction = reflect(ray.direction, modified_normals);
+        ray.pos += hit.normal * 0.01;
+        return true;
     }
+    ray.color += hit_color * (1 - ray.color.w);
+    return false;
+}
+vec3 finish_ray(Ray ray) {
+    Material start_material = get_material(ray.start_value);
+    vec4 final_color = ray.color;
 
     // last unused volume
     final_color += vec4(start_material.volume_color, 1) * (1 - final_color.w);// * smooth_sign(start_material.volume * distance(pos, hit.hit_point));
@@ -471,39 +601,375 @@ vec3 get_color() {
 
     return final_color.xyz;
 }
+vec3 get_color(float beam) {
+    Ray ray = new_ray(beam);
+    for (uint b = 0; b <= MAX_BOUNCE; b++) {
+        if (!trace_bounce(ray, b)) break;
+    }
+    return finish_ray(ray);
+}
 
 
 
 
 
 
-void main()
-{
+//#region depth pre-pass
+// distance along direction that the beam of radius spread * distance holds only the start material
+// the beam is tested against nodes at least 4 times its radius: a step of half a node then touches at most 2 nodes per axis
+float beam_distance(vec3 direction, float spread, uint start_value) {
+    TreeCursor cursor = new_cursor();
+    float t = 0.5;
+    for (int i = 0; i < BEAM_ITER && t < MAX_DISTANCE; i++) {
+        float size = 1;
+        while (size <= CHUNK_WIDTH && 4 * (t + size * 0.5) * spread > size) size *= 2;
+        // past the size of a chunk there is no node to test against
+        if (size > CHUNK_WIDTH) break;
+
+        float end = t + size * 0.5;
+        float radius = end * spread;
+        vec3 a = player_position + direction * t;
+        vec3 b = player_position + direction * end;
+        ivec3 low = ivec3(floor((min(a, b) - radius) / size));
+        ivec3 high = ivec3(floor((max(a, b) + radius) / size));
+
+        for (int corner = 0; corner < 8; corner++) {
+            ivec3 side = ivec3((corner >> 2) & 1, (corner >> 1) & 1, corner & 1);
+            if (any(greaterThan(side, high - low))) continue;
+
+            // the node is empty if the region holding its first cell covers it
+            tree_lookup(cursor, (low + side) * int(size));
+            if (cursor.value != start_value || cursor.size < uint(size)) return t;
+        }
+        t = end;
+    }
+    return min(t, MAX_DISTANCE);
+}
+// beam of a DEPTH_TILE x DEPTH_TILE tile of the scene, wide enough for the rays of all its pixels
+float tile_distance(uvec2 tile) {
+    vec2 tile_center = (vec2(tile) + 0.5) * DEPTH_TILE / render_scale;
+    vec3 direction = get_direction(tile_center, facing_pitch, facing_yaw, FOV);
+
+    // the farthest direction of the tile from the center is a corner, the chord bounds the beam radius per unit of distance
+    float spread = 0;
+    for (int corner = 0; corner < 4; corner++) {
+        vec2 side = vec2(corner & 1, corner >> 1) * 2 - 1;
+        vec2 corner_coord = tile_center + side * (0.5 * DEPTH_TILE / render_scale);
+        spread = max(spread, distance(direction, get_direction(corner_coord, facing_pitch, facing_yaw, FOV)));
+    }
+    spread = spread * 1.01 + 0.0001;
+
+    return beam_distance(direction, spread, get_cell_value(player_position).value);
+}
+//#endregion
+
+//#region temporal reprojection
+// the tiles of a temporal_block² group take turns, a pixel is traced at least every temporal_block² frames
+// whole tiles are traced or reprojected so neighbouring invocations take the same branch
+bool is_traced() {
+    if (history_valid == 0 || temporal_block <= 1) return true;
+    uvec2 tile = (uvec2(pixel_coord) / TEMPORAL_TILE) % temporal_block;
+    return tile.x + tile.y * temporal_block == frame_index % (temporal_block * temporal_block);
+}
+// color and depth of this pixel in the last frame, false on a disocclusion (the pixel has to be traced)
+bool reproject(out vec4 result) {
+    ivec2 history_size = textureSize(previous_history, 0);
+    vec3 direction = get_direction();
+
+    // the depth of this pixel is unknown: start from the last depth at the same place and move to where the point was
+    ivec2 texel = ivec2(frag_coord * previous_render_scale);
+    float depth = texelFetch(previous_history, clamp(texel, ivec2(0), history_size - 1), 0).a;
+    for (int i = 0; i < 2; i++) {
+        if (depth < 0) return false;
+
+        vec2 coord;
+        if (!project_previous(player_position + direction * depth, coord)) return false;
+        texel = ivec2(coord * previous_render_scale);
+        if (any(lessThan(coord, vec2(0))) || any(greaterThanEqual(coord, WindowSize))) return false;
+
+        result = texelFetch(previous_history, texel, 0);
+        if (result.a < 0) return false;
+        // point seen by the last frame, as distance from the current camera
+        vec3 point = previous_position + get_direction(coord, previous_pitch, previous_yaw, previous_FOV) * result.a;
+        depth = distance(player_position, point);
+    }
+
+    // the history must see the same surface: same distance from the previous camera
+    vec3 point = player_position + direction * depth;
+    if (abs(distance(previous_position, point) - result.a) > 0.05 + result.a * 0.02) return false;
+
+    result.a = depth;
+    return true;
+}
+//#endregion
+
+// hud and crosshair drawn over the scene, false if the pixel shows the scene
+bool get_overlay(out vec4 color) {
     int fps = int(round(1 / max(1/120, deltatime)));
-    if (gl_FragCoord.x < 5 && gl_FragCoord.y < fps * (WindowSize.y / 120)) {
-        if (fps >= 60) LFragment = vec4(0, 1, 0, 1.0);
-        else if (fps >= 30) LFragment = vec4(1, 1, 0, 1.0);
-        else if (fps >= 15) LFragment = vec4(1, 0, 0, 1.0);
-        else LFragment = vec4(0, 0, 0, 1.0);
+    if (frag_coord.x < 5 && frag_coord.y < fps * (WindowSize.y / 120)) {
+        if (fps >= 60) color = vec4(0, 1, 0, 1.0);
+        else if (fps >= 30) color = vec4(1, 1, 0, 1.0);
+        else if (fps >= 15) color = vec4(1, 0, 0, 1.0);
+        else color = vec4(0, 0, 0, 1.0);
+        return true;
+    }
+
+    vec3 d_times = debug_time / (debug_time.x + debug_time.y + debug_time.z) * WindowSize.y;
+    if (frag_coord.x >= 5 && frag_coord.x < 10) {
+        if (frag_coord.y < d_times.x) color = vec4(0, 1, 0, 1.0);
+        else if (frag_coord.y < d_times.x + d_times.y) color = vec4(1, 0, 1, 1.0);
+        else color = vec4(0, 0, 1, 1.0);
+        return true;
+    }
+
+    float x = frag_coord.x - WindowSize.x / 2;
+    float y = frag_coord.y - WindowSize.y / 2;
+
+    if (abs(x) <= 1 && abs(y) <= 32 || abs(y) <= 1 && abs(x) <= 32) { // cross
+        color = vec4(1.0, 1.0, 1.0, 1.0);
+        return true;
+    }
+    return false;
+}
+
+//#region picking
+// what the crosshair ray hit, read back by the engine a frame later (Screen::get_pick)
+struct Pick {
+    vec3 hit_point;
+    float distance;
+    vec3 normal;
+    uint value;
+    vec3 origin; // camera of the frame, the engine only uses the pick while it has not moved
+    float pitch;
+    float yaw;
+    uint has_hit;
+    uint frame;
+    uint tick; // written by the engine
+};
+layout(std430, binding = 8) writeonly buffer pick_layout {
+    Pick pick;
+};
+// the one pixel under the crosshair
+bool is_pick_pixel() {
+    return uvec2(pixel_coord) == uvec2(WindowSize * render_scale * 0.5);
+}
+// same rules as World::raycast: solid materials stop the ray, the others (water) are crossed
+void write_pick() {
+    vec3 direction = get_direction(WindowSize * 0.5, facing_pitch, facing_yaw, FOV);
+    pick.origin = player_position;
+    pick.pitch = facing_pitch;
+    pick.yaw = facing_yaw;
+    pick.frame = frame_index;
+
+    vec3 pos = player_position;
+    uint start_value = get_cell_value(pos).value;
+    RaycastHit hit = RaycastHit(start_value, pos, -direction, 0);
+    int step_left = MAX_ITER;
+    bool has_hit = (get_material(start_value).flags & MATERIAL_SOLID) != 0;
+    for (int i = 0; i < 4 && !has_hit; i++) {
+        float dist_left = MAX_DISTANCE - distance(player_position, pos);
+        if (dist_left <= 0 || step_left <= 0) break;
+
+        hit = raycast(direction, pos, step_left, dist_left, start_value);
+        step_left -= hit.step_taken;
+        // nothing but the start material until the end
+        if (hit.value == start_value) break;
+
+        has_hit = (get_material(hit.value).flags & MATERIAL_SOLID) != 0;
+        pos = hit.hit_point - hit.normal * 0.01;
+        start_value = hit.value;
+    }
+
+    pick.has_hit = has_hit ? 1u : 0u;
+    pick.hit_point = hit.hit_point;
+    pick.normal = hit.normal;
+    pick.distance = distance(player_position, hit.hit_point);
+    pick.value = hit.value;
+}
+//#endregion
 
+#ifdef COMPUTE_RENDERER
+//#region compute renderer
+// the passes of a frame: primary rays, then for each bounce sort, scatter and bounce
+#define COMPUTE_PRIMARY 0
+#define COMPUTE_SORT 1
+#define COMPUTE_SCATTER 2
+#define COMPUTE_BOUNCE 3
+uniform uint compute_pass;
+uniform uint compute_bounce;
+uniform uvec2 scene_size;
+
+// one bin per material, unknown materials share the last one
+const uint RAY_BINS = MATERIAL_COUNT + 1;
+// rays waiting for their next bounce, by pixel
+struct QueuedRay {
+    vec4 pos_dist;         // pos, dist_left
+    vec4 direction_depth;  // direction, primary depth
+    vec4 color;
+    uvec4 state;           // step_left, start_value, coord_offset, hit_value
+};
+layout(std430, binding = 3) buffer ray_layout {
+    QueuedRay rays[];
+};
+// pixels queued by the last wave, then the same pixels sorted by hit material
+layout(std430, binding = 4) buffer ray_queue_layout {
+    uint ray_queue[];
+};
+layout(std430, binding = 5) buffer ray_sorted_layout {
+    uint ray_sorted[];
+};
+layout(std430, binding = 6) buffer ray_counter_layout {
+    uvec3 dispatch_size;   // indirect arguments of the scatter and bounce passes
+    uint ray_count;        // rays of the wave being traced
+    uint queued_count;     // rays queued for the next wave
+    uint bin_count[RAY_BINS];
+    uint bin_offset[RAY_BINS];
+};
+
+void store_pixel(uvec2 pixel, vec4 color, vec4 history_color) {
+    imageStore(scene_image, ivec2(pixel), color);
+    imageStore(history_image, ivec2(pixel), history_color);
+}
+void set_pixel(uint slot) {
+    pixel_coord = vec2(slot % scene_size.x, slot / scene_size.x) + 0.5;
+    frag_coord = pixel_coord / render_scale;
+}
+void queue_ray(uint slot, Ray ray) {
+    uint bin = min(ray.hit_value, RAY_BINS - 1);
+    rays[slot] = QueuedRay(vec4(ray.pos, ray.dist_left), vec4(ray.direction, primary_depth), ray.color,
+        uvec4(uint(ray.step_left), ray.start_value, ray.coord_offset, bin));
+    ray_queue[atomicAdd(queued_count, 1u)] = slot;
+    atomicAdd(bin_count[bin], 1u);
+}
+Ray load_ray(uint slot) {
+    QueuedRay queued = rays[slot];
+    Ray ray;
+    ray.pos = queued.pos_dist.xyz;
+    ray.dist_left = queued.pos_dist.w;
+    ray.direction = queued.direction_depth.xyz;
+    primary_depth = queued.direction_depth.w;
+    ray.color = queued.color;
+    ray.step_left = int(queued.state.x);
+    ray.start_value = queued.state.y;
+    ray.coord_offset = queued.state.z;
+    ray.skip = 0;
+    ray.hit_value = AIR;
+    return ray;
+}
+
+// distances of the DEPTH_TILE tiles of the workgroup
+shared float tile_beams[4];
+void primary_pass() {
+    // 16x16 pixels per workgroup, split in 8x8 tiles so a warp stays in one tile (temporal and depth tiles)
+    uint index = gl_LocalInvocationIndex;
+    uvec2 tile = gl_WorkGroupID.xy * 2 + uvec2((index >> 6) & 1, index >> 7);
+    uvec2 pixel = tile * 8 + uvec2(index & 7, (index >> 3) & 7);
+
+    pixel_coord = vec2(pixel) + 0.5;
+    frag_coord = pixel_coord / render_scale;
+
+    if (depth_prepass != 0 && (index & 63) == 0) tile_beams[index >> 6] = tile_distance(tile);
+    barrier();
+    if (any(greaterThanEqual(pixel, scene_size))) return;
+    if (is_pick_pixel()) write_pick();
+
+    vec4 color;
+    if (get_overlay(color)) {
+        store_pixel(pixel, color, vec4(0, 0, 0, -1));
         return;
     }
 
-    vec3 d_times = debug_time / (debug_time.x + debug_time.y + debug_time.z) * WindowSize.y;
-    if (gl_FragCoord.x >= 5 && gl_FragCoord.x < 10) {
-        if (gl_FragCoord.y < d_times.x) LFragment = vec4(0, 1, 0, 1.0);
-        else if (gl_FragCoord.y < d_times.x + d_times.y) LFragment = vec4(1, 0, 1, 1.0);
-        else LFragment = vec4(0, 0, 1, 1.0);
+    vec4 reprojected;
+    if (!is_traced() && reproject(reprojected)) {
+        store_pixel(pixel, vec4(reprojected.rgb, 1.0), reprojected);
+        return;
+    }
 
+    Ray ray = new_ray(depth_prepass != 0 ? tile_beams[index >> 6] : 0);
+    bool bounced = trace_bounce(ray, 0);
+    if (bounced && MAX_BOUNCE > 0) {
+        queue_ray(pixel.y * scene_size.x + pixel.x, ray);
         return;
     }
+    vec3 final_color = finish_ray(ray);
+    store_pixel(pixel, vec4(final_color, 1.0), vec4(final_color, primary_depth));
+}
+void sort_pass() {
+    if (gl_LocalInvocationIndex != 0) return;
+
+    uint offset = 0;
+    for (uint bin = 0; bin < RAY_BINS; bin++) {
+        bin_offset[bin] = offset;
+        offset += bin_count[bin];
+        bin_count[bin] = 0;
+    }
+    ray_count = queued_count;
+    queued_count = 0;
+    dispatch_size = uvec3((ray_count + gl_WorkGroupSize.x - 1) / gl_WorkGroupSize.x, 1, 1);
+}
+void scatter_pass() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= ray_count) return;
 
-    float x = gl_FragCoord.x - WindowSize.x / 2;
-    float y = gl_FragCoord.y - WindowSize.y / 2;
+    uint slot = ray_queue[index];
+    ray_sorted[atomicAdd(bin_offset[rays[slot].state.w], 1u)] = slot;
+}
+void bounce_pass() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= ray_count) return;
+
+    uint slot = ray_sorted[index];
+    set_pixel(slot);
+    Ray ray = load_ray(slot);
+    bool bounced = trace_bounce(ray, compute_bounce);
+    if (bounced && compute_bounce < MAX_BOUNCE) {
+        queue_ray(slot, ray);
+        return;
+    }
+    vec3 final_color = finish_ray(ray);
+    store_pixel(uvec2(slot % scene_size.x, slot / scene_size.x), vec4(final_color, 1.0), vec4(final_color, primary_depth));
+}
 
-    if (abs(x) <= 1 && abs(y) <= 32 || abs(y) <= 1 && abs(x) <= 32) // cross
-        LFragment = vec4(1.0, 1.0, 1.0, 1.0);
+void main()
+{
+    if (compute_pass == COMPUTE_SORT) sort_pass();
+    else if (compute_pass == COMPUTE_SCATTER) scatter_pass();
     else {
-        LFragment = vec4(get_color(), 1.0);
+        load_index_cache();
+        if (compute_pass == COMPUTE_PRIMARY) primary_pass();
+        else bounce_pass();
+    }
+}
+//#endregion
+#else
+void main()
+{
+    if (depth_pass != 0) {
+        LFragment = vec4(tile_distance(uvec2(gl_FragCoord.xy)), 0, 0, 1);
+        return;
     }
-}
\ No newline at end of file
+    pixel_coord = gl_FragCoord.xy;
+    frag_coord = pixel_coord / render_scale;
+    if (is_pick_pixel()) write_pick();
+
+    vec4 color;
+    if (get_overlay(color)) {
+        LFragment = color;
+        history = vec4(0, 0, 0, -1);
+        return;
+    }
+
+    vec4 reprojected;
+    if (!is_traced() && reproject(reprojected)) {
+        LFragment = vec4(reprojected.rgb, 1.0);
+        history = reprojected;
+        return;
+    }
+
+    // the first ray starts where the beam of its tile stopped
+    float beam = 0;
+    if (depth_prepass != 0) beam = texelFetch(tile_depth, ivec2(gl_FragCoord.xy) / int(DEPTH_TILE), 0).r;
+    LFragment = vec4(get_color(beam), 1.0);
+    history = vec4(LFragment.rgb, primary_depth);
+}
+#endif
\ No newline at end of file